@@ -0,0 +1,96 @@
+// Per-request overhead of the http_request fetch path.
+//
+// "before" replays what every fetch used to do: open a Connection, LOAD http_request and run a freshly
+// formatted http_get query. The session runs go through HttpSession, once with the http_request backend
+// (one connection and prepared statement per thread) and once with the native backend (pooled keep-alive
+// connections). All runs hit a local server so the difference is client-side cost.
+//
+// Usage: sitemap_http_session_benchmark [requests]
+
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "http_client.hpp"
+#include "sitemap_extension.hpp"
+#include "local_http_server.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace duckdb;
+using sitemap_benchmark::LocalHttpServer;
+using sitemap_benchmark::LocalResponse;
+
+static const char *SMALL_SITEMAP = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                                   "<urlset xmlns=\"http://www.sitemaps.org/schemas/sitemap/0.9\">"
+                                   "<url><loc>https://example.com/</loc></url>"
+                                   "</urlset>";
+
+static double ElapsedMicros(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+	int requests = argc > 1 ? std::atoi(argv[1]) : 500;
+
+	LocalHttpServer server([](const std::string &, const std::string &) {
+		LocalResponse response;
+		response.body = SMALL_SITEMAP;
+		return response;
+	});
+	auto url = server.BaseUrl() + "/sitemap.xml";
+	const std::string user_agent = "DuckDB-Sitemap/1.0";
+
+	DuckDB db(nullptr);
+	db.LoadStaticExtension<SitemapExtension>();
+	Connection con(db);
+	auto install = con.Query("INSTALL http_request FROM community");
+	if (install->HasError()) {
+		fprintf(stderr, "INSTALL http_request failed: %s\n", install->GetError().c_str());
+		return 1;
+	}
+
+	// Before: new connection, LOAD and an ad-hoc query for every request
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < requests; i++) {
+		Connection conn(*db.instance);
+		conn.Query("LOAD http_request");
+		auto query = StringUtil::Format("SELECT status, decode(body) AS body, content_type, "
+		                                "headers['retry-after'] AS retry_after "
+		                                "FROM http_get('%s', headers := {'User-Agent': '%s'})",
+		                                url, user_agent);
+		auto result = conn.Query(query);
+		if (result->HasError()) {
+			fprintf(stderr, "request failed: %s\n", result->GetError().c_str());
+			return 1;
+		}
+	}
+	double before_us = ElapsedMicros(start) / requests;
+
+	auto run_session = [&](const char *backend) {
+		con.Query(StringUtil::Format("SET sitemap_http_backend = '%s'", backend));
+		HttpSession session(*con.context, user_agent);
+		auto session_start = std::chrono::steady_clock::now();
+		for (int i = 0; i < requests; i++) {
+			auto response = session.Request(url);
+			if (!response.success) {
+				fprintf(stderr, "request failed: %s\n", response.error.c_str());
+				exit(1);
+			}
+		}
+		return ElapsedMicros(session_start) / requests;
+	};
+
+	// One session for the whole run
+	double http_request_us = run_session("http_request");
+	auto connections_before_native = server.ConnectionCount();
+	double native_us = run_session("native");
+	auto native_connections = server.ConnectionCount() - connections_before_native;
+
+	printf("requests:                        %d\n", requests);
+	printf("before       (per request):      %10.1f us\n", before_us);
+	printf("http_request session (per req):  %10.1f us  (%.2fx)\n", http_request_us, before_us / http_request_us);
+	printf("native session       (per req):  %10.1f us  (%.2fx, %zu TCP connections)\n", native_us,
+	       before_us / native_us, native_connections);
+	return 0;
+}
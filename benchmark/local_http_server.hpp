@@ -0,0 +1,187 @@
+#pragma once
+
+// Minimal HTTP/1.1 server for the sitemap benchmarks. Serves responses from a handler on 127.0.0.1 so
+// that benchmark numbers measure client-side overhead rather than internet latency.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sitemap_benchmark {
+
+struct LocalResponse {
+	int status = 200;
+	std::string content_type = "application/xml";
+	std::string body;
+	// Extra response headers, e.g. ETag
+	std::vector<std::pair<std::string, std::string>> headers;
+};
+
+class LocalHttpServer {
+public:
+	using Handler = std::function<LocalResponse(const std::string &method, const std::string &path)>;
+	// Request header names are lower-cased
+	using HeaderHandler = std::function<LocalResponse(const std::string &method, const std::string &path,
+	                                                  const std::map<std::string, std::string> &headers)>;
+
+	explicit LocalHttpServer(Handler handler_p)
+	    : LocalHttpServer(HeaderHandler([handler_p](const std::string &method, const std::string &path,
+	                                                const std::map<std::string, std::string> &) {
+		      return handler_p(method, path);
+	      })) {
+	}
+
+	explicit LocalHttpServer(HeaderHandler handler_p) : handler(std::move(handler_p)) {
+		listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (listen_fd < 0) {
+			throw std::runtime_error("socket() failed");
+		}
+		int one = 1;
+		setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+		sockaddr_in addr {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 128) != 0) {
+			close(listen_fd);
+			throw std::runtime_error("bind()/listen() failed");
+		}
+		socklen_t len = sizeof(addr);
+		getsockname(listen_fd, reinterpret_cast<sockaddr *>(&addr), &len);
+		port = ntohs(addr.sin_port);
+
+		accept_thread = std::thread([this]() { AcceptLoop(); });
+	}
+
+	~LocalHttpServer() {
+		stopping = true;
+		shutdown(listen_fd, SHUT_RDWR);
+		close(listen_fd);
+		accept_thread.join();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (int fd : client_fds) {
+				shutdown(fd, SHUT_RDWR);
+			}
+		}
+		for (auto &thread : client_threads) {
+			thread.join();
+		}
+	}
+
+	std::string BaseUrl() const {
+		return "http://127.0.0.1:" + std::to_string(port);
+	}
+
+	size_t RequestCount() const {
+		return request_count.load();
+	}
+
+	size_t ConnectionCount() const {
+		return connection_count.load();
+	}
+
+private:
+	void AcceptLoop() {
+		while (!stopping) {
+			int fd = accept(listen_fd, nullptr, nullptr);
+			if (fd < 0) {
+				continue;
+			}
+			connection_count++;
+			std::lock_guard<std::mutex> lock(mutex);
+			client_fds.push_back(fd);
+			client_threads.emplace_back([this, fd]() { Serve(fd); });
+		}
+	}
+
+	void Serve(int fd) {
+		std::string buffer;
+		char chunk[8192];
+		while (!stopping) {
+			auto header_end = buffer.find("\r\n\r\n");
+			if (header_end == std::string::npos) {
+				auto n = recv(fd, chunk, sizeof(chunk), 0);
+				if (n <= 0) {
+					break;
+				}
+				buffer.append(chunk, static_cast<size_t>(n));
+				continue;
+			}
+
+			// Request line: METHOD PATH VERSION
+			auto line_end = buffer.find("\r\n");
+			auto request_line = buffer.substr(0, line_end);
+			auto method_end = request_line.find(' ');
+			auto path_end = request_line.find(' ', method_end + 1);
+			auto method = request_line.substr(0, method_end);
+			auto path = request_line.substr(method_end + 1, path_end - method_end - 1);
+
+			// Header lines: Name: value
+			std::map<std::string, std::string> headers;
+			size_t pos = line_end + 2;
+			while (pos < header_end) {
+				auto end = buffer.find("\r\n", pos);
+				auto line = buffer.substr(pos, end - pos);
+				auto colon = line.find(':');
+				if (colon != std::string::npos) {
+					auto name = line.substr(0, colon);
+					std::transform(name.begin(), name.end(), name.begin(),
+					               [](unsigned char c) { return std::tolower(c); });
+					auto value_start = line.find_first_not_of(' ', colon + 1);
+					headers[name] = value_start == std::string::npos ? "" : line.substr(value_start);
+				}
+				pos = end + 2;
+			}
+			buffer.erase(0, header_end + 4);
+			request_count++;
+
+			auto response = handler(method, path, headers);
+			std::string out = "HTTP/1.1 " + std::to_string(response.status) + " OK\r\n";
+			out += "Content-Type: " + response.content_type + "\r\n";
+			for (auto &header : response.headers) {
+				out += header.first + ": " + header.second + "\r\n";
+			}
+			out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+			out += "Connection: keep-alive\r\n\r\n";
+			if (method != "HEAD") {
+				out += response.body;
+			}
+			size_t sent = 0;
+			while (sent < out.size()) {
+				auto n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+				if (n <= 0) {
+					break;
+				}
+				sent += static_cast<size_t>(n);
+			}
+		}
+		close(fd);
+	}
+
+	HeaderHandler handler;
+	int listen_fd = -1;
+	int port = 0;
+	std::atomic<bool> stopping {false};
+	std::atomic<size_t> request_count {0};
+	std::atomic<size_t> connection_count {0};
+	std::thread accept_thread;
+	std::mutex mutex;
+	std::vector<int> client_fds;
+	std::vector<std::thread> client_threads;
+};
+
+} // namespace sitemap_benchmark
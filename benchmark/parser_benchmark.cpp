@@ -0,0 +1,177 @@
+// DOM parser versus the streaming SAX2 parser on synthetic 1 MB, 10 MB and 50 MB urlsets, both as
+// plain XML and gzipped.
+//
+// Reports wall time, URLs/second and peak heap usage (libxml2 allocations plus any fully decompressed
+// copy of the document). The streaming parser is fed in 64 KB chunks, or in the 32 KB chunks of the
+// incremental gunzip for .xml.gz, and discards entries as they arrive, the way the sitemap_urls scan
+// consumes it. "gunzip+dom" is the old .xml.gz path that inflated the whole body before parsing.
+//
+// Usage: sitemap_parser_benchmark [size_mb ...]
+
+#include "sitemap_generator.hpp"
+#include "xml_parser.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace duckdb;
+
+// libxml2 allocation tracking - every block carries its size in a header
+static size_t current_bytes = 0;
+static size_t peak_bytes = 0;
+static const size_t HEADER = 16;
+
+static void *TrackedMalloc(size_t size) {
+	auto block = static_cast<char *>(malloc(size + HEADER));
+	if (!block) {
+		return nullptr;
+	}
+	memcpy(block, &size, sizeof(size));
+	current_bytes += size;
+	peak_bytes = current_bytes > peak_bytes ? current_bytes : peak_bytes;
+	return block + HEADER;
+}
+
+static void TrackedFree(void *ptr) {
+	if (!ptr) {
+		return;
+	}
+	auto block = static_cast<char *>(ptr) - HEADER;
+	size_t size;
+	memcpy(&size, block, sizeof(size));
+	current_bytes -= size;
+	free(block);
+}
+
+static void *TrackedRealloc(void *ptr, size_t size) {
+	if (!ptr) {
+		return TrackedMalloc(size);
+	}
+	auto block = static_cast<char *>(ptr) - HEADER;
+	size_t old_size;
+	memcpy(&old_size, block, sizeof(old_size));
+	block = static_cast<char *>(realloc(block, size + HEADER));
+	if (!block) {
+		return nullptr;
+	}
+	memcpy(block, &size, sizeof(size));
+	current_bytes = current_bytes - old_size + size;
+	peak_bytes = current_bytes > peak_bytes ? current_bytes : peak_bytes;
+	return block + HEADER;
+}
+
+static char *TrackedStrdup(const char *str) {
+	auto len = strlen(str) + 1;
+	auto copy = static_cast<char *>(TrackedMalloc(len));
+	if (copy) {
+		memcpy(copy, str, len);
+	}
+	return copy;
+}
+
+struct RunResult {
+	double seconds = 0;
+	size_t urls = 0;
+	size_t peak_bytes = 0;
+};
+
+static RunResult RunDom(const std::string &xml) {
+	RunResult run;
+	peak_bytes = current_bytes;
+	auto start = std::chrono::steady_clock::now();
+	auto result = XmlParser::ParseSitemap(xml);
+	run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	run.urls = result.urls.size();
+	run.peak_bytes = peak_bytes;
+	return run;
+}
+
+static RunResult RunStreaming(const std::string &xml) {
+	RunResult run;
+	peak_bytes = current_bytes;
+	auto start = std::chrono::steady_clock::now();
+	SitemapStreamParser parser([&](SitemapEntry &) { run.urls++; }, [](SitemapIndexEntry &) {});
+	const size_t chunk_size = 64 * 1024;
+	for (size_t offset = 0; offset < xml.size(); offset += chunk_size) {
+		parser.Feed(xml.data() + offset, std::min(chunk_size, xml.size() - offset));
+	}
+	parser.Finish();
+	run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	run.peak_bytes = peak_bytes;
+	return run;
+}
+
+static RunResult RunGunzipThenDom(const std::string &gz) {
+	RunResult run;
+	peak_bytes = current_bytes;
+	auto start = std::chrono::steady_clock::now();
+	auto xml = XmlParser::DecompressGzip(gz);
+	auto result = XmlParser::ParseSitemap(xml);
+	run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	run.urls = result.urls.size();
+	run.peak_bytes = peak_bytes + xml.capacity();
+	return run;
+}
+
+static RunResult RunGzipDom(const std::string &gz) {
+	RunResult run;
+	peak_bytes = current_bytes;
+	auto start = std::chrono::steady_clock::now();
+	GzipStreamReader reader(gz);
+	auto result = XmlParser::ParseSitemap(reader);
+	run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	run.urls = result.urls.size();
+	run.peak_bytes = peak_bytes;
+	return run;
+}
+
+static RunResult RunGzipStreaming(const std::string &gz) {
+	RunResult run;
+	peak_bytes = current_bytes;
+	auto start = std::chrono::steady_clock::now();
+	SitemapStreamParser parser([&](SitemapEntry &) { run.urls++; }, [](SitemapIndexEntry &) {});
+	GzipStreamReader reader(gz);
+	const char *data;
+	size_t size;
+	while (reader.Read(data, size)) {
+		parser.Feed(data, size);
+	}
+	parser.Finish();
+	run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	run.peak_bytes = peak_bytes;
+	return run;
+}
+
+static void Report(const char *name, size_t size_mb, const RunResult &run) {
+	printf("%-10s %6zu MB %10zu urls %9.3f s %12.0f urls/s %10.1f MB peak heap\n", name, size_mb, run.urls,
+	       run.seconds, run.urls / run.seconds, run.peak_bytes / (1024.0 * 1024.0));
+}
+
+int main(int argc, char **argv) {
+	xmlMemSetup(TrackedFree, TrackedMalloc, TrackedRealloc, TrackedStrdup);
+	XmlParser::Initialize();
+
+	std::vector<size_t> sizes_mb;
+	for (int i = 1; i < argc; i++) {
+		sizes_mb.push_back(static_cast<size_t>(std::atoi(argv[i])));
+	}
+	if (sizes_mb.empty()) {
+		sizes_mb = {1, 10, 50};
+	}
+
+	for (auto size_mb : sizes_mb) {
+		auto xml = sitemap_benchmark::GenerateUrlset(size_mb * 1024 * 1024);
+		Report("dom", size_mb, RunDom(xml));
+		Report("streaming", size_mb, RunStreaming(xml));
+
+		auto gz = XmlParser::CompressGzip(xml);
+		xml = std::string();
+		Report("gunzip+dom", size_mb, RunGunzipThenDom(gz));
+		Report("dom-gz", size_mb, RunGzipDom(gz));
+		Report("stream-gz", size_mb, RunGzipStreaming(gz));
+	}
+	return 0;
+}
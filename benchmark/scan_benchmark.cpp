@@ -0,0 +1,80 @@
+// End-to-end sitemap_urls scan over 10M synthetic entries.
+//
+// A local server publishes a sitemap index whose children are 50,000-entry urlsets with every optional
+// column set. The query consumes all four columns so every row is materialized. "parse only" runs the
+// streaming parser over the same documents without DuckDB, as the floor the scan should approach.
+//
+// Usage: sitemap_scan_benchmark [entries]
+
+#include "duckdb.hpp"
+#include "xml_parser.hpp"
+#include "sitemap_extension.hpp"
+#include "local_http_server.hpp"
+#include "sitemap_generator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace duckdb;
+using sitemap_benchmark::LocalHttpServer;
+using sitemap_benchmark::LocalResponse;
+
+static const size_t ENTRIES_PER_SITEMAP = 50000;
+
+static double ElapsedSeconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+	size_t entries = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 10000000;
+	size_t children = (entries + ENTRIES_PER_SITEMAP - 1) / ENTRIES_PER_SITEMAP;
+
+	// Every child serves the same document, so the server does no per-request work
+	auto urlset = sitemap_benchmark::GenerateUrlsetEntries(ENTRIES_PER_SITEMAP);
+	std::string index;
+	LocalHttpServer server([&](const std::string &, const std::string &path) {
+		LocalResponse response;
+		if (path == "/sitemap.xml") {
+			response.body = index;
+		} else if (path.compare(0, 9, "/sitemap-") == 0) {
+			response.body = urlset;
+		} else {
+			response.status = 404;
+		}
+		return response;
+	});
+	index = sitemap_benchmark::GenerateSitemapIndex(server.BaseUrl(), children);
+
+	// Floor: parse the same number of documents with nothing downstream
+	auto start = std::chrono::steady_clock::now();
+	size_t parsed = 0;
+	for (size_t i = 0; i < children; i++) {
+		SitemapStreamParser parser([&](SitemapEntry &) { parsed++; }, [](SitemapIndexEntry &) {});
+		parser.Feed(urlset.data(), urlset.size());
+		parser.Finish();
+	}
+	double parse_seconds = ElapsedSeconds(start);
+
+	DuckDB db(nullptr);
+	db.LoadStaticExtension<SitemapExtension>();
+	Connection con(db);
+
+	start = std::chrono::steady_clock::now();
+	auto result = con.Query("SELECT count(*), sum(length(url)), count(lastmod), count(changefreq), count(priority) "
+	                        "FROM sitemap_urls('" +
+	                        server.BaseUrl() + "', follow_robots := false)");
+	double scan_seconds = ElapsedSeconds(start);
+	if (result->HasError()) {
+		fprintf(stderr, "scan failed: %s\n", result->GetError().c_str());
+		return 1;
+	}
+	auto rows = result->GetValue(0, 0).GetValue<int64_t>();
+
+	printf("sitemaps:              %zu x %zu entries\n", children, ENTRIES_PER_SITEMAP);
+	printf("parse only (1 thread): %10zu rows %8.3f s %12.0f rows/s\n", parsed, parse_seconds,
+	       parsed / parse_seconds);
+	printf("sitemap_urls scan:     %10lld rows %8.3f s %12.0f rows/s\n", static_cast<long long>(rows), scan_seconds,
+	       rows / scan_seconds);
+	return 0;
+}
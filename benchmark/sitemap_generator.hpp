@@ -0,0 +1,57 @@
+#pragma once
+
+// Synthetic sitemap documents for the sitemap benchmarks.
+
+#include <cstdio>
+#include <string>
+
+namespace sitemap_benchmark {
+
+inline void AppendUrlEntry(std::string &xml, size_t i) {
+	char entry[512];
+	snprintf(entry, sizeof(entry),
+	         "  <url>\n"
+	         "    <loc>https://www.example.com/products/category-%zu/item-%zu.html</loc>\n"
+	         "    <lastmod>2026-%02zu-%02zuT10:00:00+00:00</lastmod>\n"
+	         "    <changefreq>daily</changefreq>\n"
+	         "    <priority>0.%zu</priority>\n"
+	         "  </url>\n",
+	         i % 97, i, i % 12 + 1, i % 28 + 1, i % 10);
+	xml += entry;
+}
+
+// <urlset> with every optional field set, grown until it reaches target_bytes
+inline std::string GenerateUrlset(size_t target_bytes) {
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	                  "<urlset xmlns=\"http://www.sitemaps.org/schemas/sitemap/0.9\">\n";
+	for (size_t i = 0; xml.size() < target_bytes; i++) {
+		AppendUrlEntry(xml, i);
+	}
+	xml += "</urlset>\n";
+	return xml;
+}
+
+// <urlset> with exactly entries <url> elements
+inline std::string GenerateUrlsetEntries(size_t entries) {
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	                  "<urlset xmlns=\"http://www.sitemaps.org/schemas/sitemap/0.9\">\n";
+	for (size_t i = 0; i < entries; i++) {
+		AppendUrlEntry(xml, i);
+	}
+	xml += "</urlset>\n";
+	return xml;
+}
+
+// <sitemapindex> pointing at child sitemaps under base_url
+inline std::string GenerateSitemapIndex(const std::string &base_url, size_t children) {
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	                  "<sitemapindex xmlns=\"http://www.sitemaps.org/schemas/sitemap/0.9\">\n";
+	for (size_t i = 0; i < children; i++) {
+		xml += "  <sitemap><loc>" + base_url + "/sitemap-" + std::to_string(i) +
+		       ".xml</loc><lastmod>2026-01-01</lastmod></sitemap>\n";
+	}
+	xml += "</sitemapindex>\n";
+	return xml;
+}
+
+} // namespace sitemap_benchmark
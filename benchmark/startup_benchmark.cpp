@@ -0,0 +1,65 @@
+// Startup cost of the sitemap extension, as paid by short-lived processes.
+//
+// Every iteration opens a fresh in-memory database. "open" is the floor without the extension, "LOAD sitemap"
+// adds the extension load and "before" additionally replays what every load used to do: INSTALL and LOAD
+// http_request from the community repository. The "before" run needs network access and is skipped when the
+// install fails.
+//
+// Usage: sitemap_startup_benchmark [iterations]
+
+#include "duckdb.hpp"
+#include "sitemap_extension.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace duckdb;
+
+static double ElapsedMillis(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+	int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		DuckDB db(nullptr);
+		Connection con(db);
+	}
+	double open_ms = ElapsedMillis(start) / iterations;
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		DuckDB db(nullptr);
+		db.LoadStaticExtension<SitemapExtension>();
+		Connection con(db);
+	}
+	double load_ms = ElapsedMillis(start) / iterations;
+
+	double before_ms = -1;
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		DuckDB db(nullptr);
+		db.LoadStaticExtension<SitemapExtension>();
+		Connection con(db);
+		auto install = con.Query("INSTALL http_request FROM community");
+		if (install->HasError()) {
+			fprintf(stderr, "skipping before run, INSTALL http_request failed: %s\n", install->GetError().c_str());
+			break;
+		}
+		con.Query("LOAD http_request");
+		if (i == iterations - 1) {
+			before_ms = ElapsedMillis(start) / iterations;
+		}
+	}
+
+	printf("iterations:                 %d\n", iterations);
+	printf("open           (per start): %10.2f ms\n", open_ms);
+	printf("LOAD sitemap   (per start): %10.2f ms  (+%.2f ms)\n", load_ms, load_ms - open_ms);
+	if (before_ms >= 0) {
+		printf("before         (per start): %10.2f ms  (%.2fx)\n", before_ms, before_ms / load_ms);
+	}
+	return 0;
+}
@@ -16,6 +16,7 @@
  */
 
 #include "bruteforce_finder.hpp"
+#include <unordered_set>
 
 namespace duckdb {
 
@@ -27,6 +28,34 @@ std::vector<std::string> BruteforceFinder::GetFiletypes() {
 	};
 }
 
+std::vector<std::string> BruteforceFinder::GetCommonCandidates() {
+	return {
+		"sitemap.xml", "sitemap_index.xml", "wp-sitemap.xml", "sitemap-index.xml",
+		"sitemap.xml.gz", "sitemap_index.xml.gz", "sitemap.txt", "sitemapindex.xml",
+		"sitemap/sitemap.xml", "sitemaps/sitemap.xml", "sitemap1.xml",
+		"post-sitemap.xml", "page-sitemap.xml", "product-sitemap.xml"
+	};
+}
+
+std::vector<std::string> BruteforceFinder::GetCandidates() {
+	std::vector<std::string> candidates;
+	std::unordered_set<std::string> seen;
+	for (auto &candidate : GetCommonCandidates()) {
+		if (seen.insert(candidate).second) {
+			candidates.push_back(candidate);
+		}
+	}
+	for (const auto &filename : GetFilenames()) {
+		for (const auto &filetype : GetFiletypes()) {
+			auto candidate = filename + "." + filetype;
+			if (seen.insert(candidate).second) {
+				candidates.push_back(candidate);
+			}
+		}
+	}
+	return candidates;
+}
+
 std::vector<std::string> BruteforceFinder::GetFilenames() {
 	return {
 		"1", "1-1", "1_index_sitemap", "1_de_0_sitemap", "1_en_0_sitemap",
@@ -1,11 +1,23 @@
 #include "bruteforce_function.hpp"
 #include "bruteforce_finder.hpp"
+#include "bruteforce_planner.hpp"
+#include "fetch_engine.hpp"
 #include "http_client.hpp"
+#include "xml_parser.hpp"
 #include "duckdb/function/scalar_function.hpp"
+#include "duckdb/function/table_function.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/config.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
 
 namespace duckdb {
 
@@ -24,10 +36,63 @@ static std::string BuildUrl(const std::string &base_url, const std::string &path
 	return base + path;
 }
 
-// Scalar function implementation
-static void BruteforceFindSitemapFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &context = state.GetContext();
+// Base URL of a site to probe; https:// is assumed without a scheme. Directory pruning and the soft-404
+// baseline rely on how web servers answer missing paths, so local file:// trees are not supported.
+static std::string SiteBaseUrl(const char *function_name, std::string base_url) {
+	if (base_url.find("://") == std::string::npos) {
+		base_url = "https://" + base_url;
+	}
+	if (HttpSession::IsFileUrl(base_url)) {
+		throw InvalidInputException("%s() does not support file:// URLs", function_name);
+	}
+	return base_url;
+}
+
+// What a bruteforce execution probes with - one fetch session, the probe pool and the candidate plan
+struct BruteforceProber {
+	unique_ptr<HttpSession> session;
+	unique_ptr<FetchEngine> engine;
+	// Candidate paths in probe order
+	unique_ptr<BruteforcePlan> plan;
+
+	~BruteforceProber() {
+		engine.reset();
+	}
+};
+
+// Persists the candidate hit rates once per query, after all of its probers are done. Every thread of a
+// bruteforce_find_sitemap() execution has its own prober, so saving from the probers would write the
+// file once per thread.
+class BruteforceStatsSaver : public ClientContextState {
+public:
+	static shared_ptr<BruteforceStatsSaver> Get(ClientContext &context) {
+		return context.registered_state->GetOrCreate<BruteforceStatsSaver>("sitemap_bruteforce_stats_saver");
+	}
 
+	// Save the counts to directory when the current query ends
+	void SaveAtQueryEnd(const std::string &directory_p) {
+		std::lock_guard<std::mutex> lock(mutex);
+		directory = directory_p;
+	}
+
+	void QueryEnd(ClientContext &context) override {
+		std::string save_directory;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			std::swap(save_directory, directory);
+		}
+		if (!save_directory.empty()) {
+			BruteforceStats::GetInstance().Save(FileSystem::GetFileSystem(context), save_directory);
+		}
+	}
+
+private:
+	std::mutex mutex;
+	// Empty unless a bruteforce function ran in the current query
+	std::string directory;
+};
+
+static void InitProber(ClientContext &context, BruteforceProber &prober) {
 	// Get user agent from extension setting
 	std::string user_agent;
 	Value user_agent_value;
@@ -35,21 +100,286 @@ static void BruteforceFindSitemapFunction(DataChunk &args, ExpressionState &stat
 		user_agent = user_agent_value.GetValue<std::string>();
 	}
 
+	// Get probe fan-out from extension setting
+	idx_t concurrency = 16;
+	Value concurrency_value;
+	if (context.TryGetCurrentSetting("sitemap_bruteforce_concurrency", concurrency_value)) {
+		concurrency = static_cast<idx_t>(concurrency_value.GetValue<int64_t>());
+	}
+
+	prober.session = make_uniq<HttpSession>(context, user_agent);
+	prober.engine = make_uniq<FetchEngine>(concurrency);
+
+	// Probes are mostly HEAD requests; at sitemap_max_host_rps a single site would take minutes. They get
+	// their own rate, and every probe slot may target the same host.
+	auto limits = prober.session->Limits();
+	limits.max_concurrency = MaxValue<idx_t>(limits.max_concurrency, concurrency);
+	Value rps_value;
+	if (context.TryGetCurrentSetting("sitemap_bruteforce_max_host_rps", rps_value)) {
+		limits.requests_per_second = rps_value.GetValue<double>();
+	}
+	prober.session->SetLimits(limits);
+
+	// Rank candidates by the hit rates seen so far, including earlier sessions
+	auto &stats = BruteforceStats::GetInstance();
+	std::string stats_directory;
+	Value dir_value;
+	if (context.TryGetCurrentSetting("sitemap_cache_dir", dir_value) && !dir_value.IsNull()) {
+		stats_directory = dir_value.GetValue<std::string>();
+	}
+	if (!stats_directory.empty()) {
+		stats.Load(FileSystem::GetFileSystem(context), stats_directory);
+		BruteforceStatsSaver::Get(context)->SaveAtQueryEnd(stats_directory);
+	}
+	prober.plan = make_uniq<BruteforcePlan>(BruteforceFinder::GetCandidates(), BruteforceFinder::GetCommonCandidates(),
+	                                        stats);
+}
+
+// Per-thread state - keeps one prober alive for the whole execution
+struct BruteforceLocalState : public FunctionLocalState {
+	BruteforceProber prober;
+};
+
+static unique_ptr<FunctionLocalState> BruteforceInitLocalState(ExpressionState &state,
+                                                               const BoundFunctionExpression &expr,
+                                                               FunctionData *bind_data) {
+	auto local_state = make_uniq<BruteforceLocalState>();
+	InitProber(state.GetContext(), local_state->prober);
+	return std::move(local_state);
+}
+
+// Body bytes a probe downloads to sniff the format of a candidate
+static constexpr idx_t SNIFF_BYTES = 4096;
+
+// Outcome of probing one candidate URL
+struct BruteforceProbe {
+	int status_code = 0;
+	std::string content_type;
+	idx_t bytes = 0; // Body bytes downloaded
+	SitemapSniff sniff = SitemapSniff::NONE;
+};
+
+// What a response looks like without its URL: status, type, length and a hash of the sniffed prefix
+struct ResponseFingerprint {
+	int status_code = 0;
+	std::string content_type;
+	int64_t length = -1; // -1 if unknown
+	size_t body_hash = 0;
+
+	// HEAD responses only carry the headers
+	static ResponseFingerprint FromHead(const HttpResponse &response) {
+		ResponseFingerprint fingerprint;
+		fingerprint.status_code = response.status_code;
+		fingerprint.content_type = response.content_type;
+		fingerprint.length = response.content_length;
+		return fingerprint;
+	}
+
+	static ResponseFingerprint FromGet(const HttpResponse &response) {
+		auto fingerprint = FromHead(response);
+		if (fingerprint.length < 0 && !response.truncated) {
+			fingerprint.length = static_cast<int64_t>(response.body.size());
+		}
+		fingerprint.body_hash = std::hash<std::string>()(response.body);
+		return fingerprint;
+	}
+
+	bool SameHead(const ResponseFingerprint &other) const {
+		return status_code == other.status_code && content_type == other.content_type && length >= 0 &&
+		       length == other.length;
+	}
+
+	bool SameBody(const ResponseFingerprint &other) const {
+		return SameHead(other) && body_hash == other.body_hash;
+	}
+};
+
+// Probe state of one site, shared by all of its candidates
+struct BruteforceSite {
+	DirectoryPruner pruner;
+	// Soft-404 baseline: the response to a random path that cannot exist. A site that answers it with
+	// 2xx is a catch-all: only its common candidates are probed, and one that gets the same response
+	// is rejected.
+	std::once_flag baseline_once;
+	bool catch_all = false;
+	ResponseFingerprint baseline;
+};
+
+static bool IsHtml(const std::string &content_type) {
+	return StringUtil::Contains(StringUtil::Lower(content_type), "html");
+}
+
+// File name that no site has
+static std::string RandomFileName() {
+	static const char *HEX_DIGITS = "0123456789abcdef";
+	std::random_device random;
+	std::string name;
+	for (idx_t i = 0; i < 16; i++) {
+		name += HEX_DIGITS[random() % 16];
+	}
+	return name + ".xml";
+}
+
+// Whether the site lacks a directory. A 404 for the directory URL alone proves nothing: servers answer
+// it for any directory without an index page, including ones that hold sitemaps. It only counts when
+// a random file inside the directory gets the very same 404 / 410, i.e. the server has nothing that
+// handles paths below it differently.
+static bool ProbeDirectoryAbsent(HttpSession &session, const std::string &directory_url, const RetryConfig &config) {
+	HttpRequestOptions options;
+	options.method = HttpMethod::HEAD;
+	auto response = HttpClient::Fetch(session, directory_url, config, options);
+	if (response.status_code != 404 && response.status_code != 410) {
+		return false;
+	}
+	auto proof = HttpClient::Fetch(session, BuildUrl(directory_url, RandomFileName()), config, options);
+	return ResponseFingerprint::FromHead(proof).SameHead(ResponseFingerprint::FromHead(response));
+}
+
+// Fetch the site's response to a random path, capped like a candidate probe
+static void FetchBaseline(HttpSession &session, const std::string &base_url, const RetryConfig &config,
+                          BruteforceSite &site) {
+	HttpRequestOptions options;
+	options.max_body_bytes = SNIFF_BYTES;
+	auto response = HttpClient::Fetch(session, BuildUrl(base_url, RandomFileName()), config, options);
+	site.catch_all = response.success;
+	site.baseline = ResponseFingerprint::FromGet(response);
+}
+
+// HEAD first: most candidates end there with a 404 or an HTML page. Anything else is confirmed by
+// sniffing the first SNIFF_BYTES of a GET for urlset / sitemapindex XML (gzipped or not), or for a
+// URL list if the candidate is a .txt file. Servers that reject HEAD get the capped GET right away.
+// On a catch-all site, responses matching the soft-404 baseline are rejected - by their headers
+// where the Content-Length allows, by the body prefix otherwise.
+static BruteforceProbe ProbeCandidate(HttpSession &session, const std::string &url, const RetryConfig &config,
+                                      const BruteforceSite &site) {
+	BruteforceProbe probe;
+
+	HttpRequestOptions options;
+	options.method = HttpMethod::HEAD;
+	auto response = HttpClient::Fetch(session, url, config, options);
+	probe.status_code = response.status_code;
+	probe.content_type = response.content_type;
+	bool head_rejected = response.status_code == 405 || response.status_code == 501;
+	if (!head_rejected && (!response.success || IsHtml(response.content_type))) {
+		return probe;
+	}
+	if (site.catch_all && !head_rejected && ResponseFingerprint::FromHead(response).SameHead(site.baseline)) {
+		return probe;
+	}
+
+	options.method = HttpMethod::GET;
+	options.max_body_bytes = SNIFF_BYTES;
+	response = HttpClient::Fetch(session, url, config, options);
+	probe.status_code = response.status_code;
+	probe.content_type = response.content_type;
+	probe.bytes = response.body.size();
+	if (!response.success || IsHtml(response.content_type)) {
+		return probe;
+	}
+	if (site.catch_all && ResponseFingerprint::FromGet(response).SameBody(site.baseline)) {
+		return probe;
+	}
+	probe.sniff = XmlParser::SniffSitemap(response.body);
+	if (probe.sniff == SitemapSniff::URL_LIST && !StringUtil::EndsWith(url, ".txt")) {
+		// A text page that starts with a link is only a sitemap where a text sitemap is expected
+		probe.sniff = SitemapSniff::NONE;
+	}
+	return probe;
+}
+
+// Probe one candidate of a site. The soft-404 baseline is fetched once per site before anything else,
+// then the candidate's directories are checked. Returns false if the candidate was skipped.
+static bool RunCandidate(HttpSession &session, const BruteforcePlan &plan, const std::string &base_url,
+                         BruteforceSite &site, idx_t candidate_idx, const RetryConfig &config,
+                         BruteforceProbe &probe) {
+	std::call_once(site.baseline_once, [&]() {
+		RetryConfig baseline_config;
+		baseline_config.max_retries = 0;
+		FetchBaseline(session, base_url, baseline_config, site);
+	});
+
+	// A catch-all answers every generated pattern with its baseline; only the well-known paths can still
+	// be real files served next to it
+	if (site.catch_all && !plan.IsCommon(candidate_idx)) {
+		return false;
+	}
+
+	// Skip generated candidates below a directory the site does not have; a catch-all has every directory,
+	// and the well-known paths are worth a request of their own
+	if (!site.catch_all && !plan.IsCommon(candidate_idx)) {
+		for (auto &directory : plan.Directories(candidate_idx)) {
+			auto directory_url = BuildUrl(base_url, directory);
+			auto probe_directory = [&]() {
+				return ProbeDirectoryAbsent(session, directory_url, config);
+			};
+			if (site.pruner.IsAbsent(directory, probe_directory)) {
+				return false;
+			}
+		}
+	}
+
+	probe = ProbeCandidate(session, BuildUrl(base_url, plan.Candidates()[candidate_idx]), config, site);
+	return true;
+}
+
+// A site being probed: a row of the chunk, or a base URL of bruteforce_sitemaps()
+struct BruteforceRow {
+	idx_t row_idx = 0;
+	std::string base_url;
+	unique_ptr<PriorityResolver> resolver; // nullptr when every candidate is probed
+	unique_ptr<BruteforceSite> site;
+};
+
+// Probes of a set of sites. They are handed out candidate-major, so every site's first candidates go
+// out before anyone's later ones and consecutive probes hit different hosts; a single slow or
+// rate-limited domain does not hold up the rest.
+struct BruteforceChunkState {
+	std::vector<BruteforceRow> rows;
+	std::mutex mutex;
+	idx_t next_candidate = 0;
+	idx_t next_row = 0;
+
+	// Next probe that is still needed: candidates behind a row's best match are skipped
+	bool Next(idx_t candidate_count, idx_t &row, idx_t &candidate) {
+		std::lock_guard<std::mutex> lock(mutex);
+		while (next_candidate < candidate_count) {
+			if (next_row >= rows.size()) {
+				next_row = 0;
+				next_candidate++;
+				continue;
+			}
+			row = next_row++;
+			candidate = next_candidate;
+			if (!rows[row].resolver || !rows[row].resolver->IsCancelled(candidate)) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+// Scalar function implementation. The probes of all rows in the chunk share the thread's FetchEngine
+// (sitemap_bruteforce_concurrency requests in flight) and the per-host scheduler. A row's result is
+// written as soon as its first match in the plan's candidate order is known: once a candidate
+// matches, the candidates after it are skipped or their requests cancelled. Every probe feeds the
+// hit rates the next plan is ranked by.
+static void BruteforceFindSitemapFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &prober = ExecuteFunctionState::GetFunctionState(state)->Cast<BruteforceLocalState>().prober;
+	auto &session = *prober.session;
+	auto &plan = *prober.plan;
+	auto &candidates = plan.Candidates();
+	auto &stats = BruteforceStats::GetInstance();
+
 	// Get base_url from first argument
 	auto &base_url_vector = args.data[0];
 	UnifiedVectorFormat base_url_data;
 	base_url_vector.ToUnifiedFormat(args.size(), base_url_data);
 	auto base_urls = UnifiedVectorFormat::GetData<string_t>(base_url_data);
 
-	RetryConfig retry_config;
-	retry_config.max_retries = 0; // No retries for bruteforce (too many URLs to check)
-
-	auto filenames = BruteforceFinder::GetFilenames();
-	auto filetypes = BruteforceFinder::GetFiletypes();
-
 	auto result_data = FlatVector::GetData<string_t>(result);
 	auto &result_validity = FlatVector::Validity(result);
 
+	BruteforceChunkState chunk_state;
 	for (idx_t i = 0; i < args.size(); i++) {
 		auto idx = base_url_data.sel->get_index(i);
 
@@ -58,51 +388,284 @@ static void BruteforceFindSitemapFunction(DataChunk &args, ExpressionState &stat
 			continue;
 		}
 
-		std::string base_url = base_urls[idx].GetString();
+		auto base_url = SiteBaseUrl("bruteforce_find_sitemap", base_urls[idx].GetString());
+		session.CheckSupported(base_url);
+
+		BruteforceRow row;
+		row.row_idx = i;
+		row.base_url = std::move(base_url);
+		row.resolver = make_uniq<PriorityResolver>(candidates.size());
+		row.site = make_uniq<BruteforceSite>();
+		chunk_state.rows.push_back(std::move(row));
+	}
+
+	// Write a row's result once its resolver has decided
+	std::mutex result_mutex;
+	auto resolve_row = [&](BruteforceRow &row) {
+		auto winner = row.resolver->Winner();
+		std::lock_guard<std::mutex> lock(result_mutex);
+		if (winner == DConstants::INVALID_INDEX) {
+			result_validity.SetInvalid(row.row_idx);
+		} else {
+			result_data[row.row_idx] = StringVector::AddString(result, BuildUrl(row.base_url, candidates[winner]));
+		}
+	};
+
+	auto probe = [&]() {
+		idx_t row_idx;
+		idx_t candidate_idx;
+		while (chunk_state.Next(candidates.size(), row_idx, candidate_idx)) {
+			auto &row = chunk_state.rows[row_idx];
+			auto &resolver = *row.resolver;
 
-		// Auto-prepend https:// if no protocol
-		if (base_url.find("://") == std::string::npos) {
-			base_url = "https://" + base_url;
+			RetryConfig retry_config;
+			retry_config.max_retries = 0; // No retries for bruteforce (too many URLs to check)
+			retry_config.is_cancelled = [&resolver, candidate_idx]() {
+				return resolver.IsCancelled(candidate_idx);
+			};
+			bool found = false;
+			try {
+				BruteforceProbe outcome;
+				if (RunCandidate(session, plan, row.base_url, *row.site, candidate_idx, retry_config, outcome)) {
+					found = outcome.sniff != SitemapSniff::NONE;
+					// A probe cancelled halfway says nothing about the candidate
+					if (found || !resolver.IsCancelled(candidate_idx)) {
+						stats.Record(candidates[candidate_idx], found);
+					}
+				}
+			} catch (std::exception &) {
+				// A failing probe is a miss, like an error response
+			}
+			if (resolver.Report(candidate_idx, found)) {
+				resolve_row(row);
+			}
 		}
+	};
 
-		bool found = false;
-		std::string found_url;
+	// One probe loop per request slot; each pulls the next needed probe until the chunk is done
+	auto &engine = *prober.engine;
+	auto loops = MinValue<idx_t>(engine.MaxInFlight(), chunk_state.rows.size() * candidates.size());
+	for (idx_t i = 0; i < loops; i++) {
+		engine.Submit(probe);
+	}
+	engine.Wait();
+}
 
-		// Try each combination of filename + filetype
-		for (const auto &filename : filenames) {
-			for (const auto &filetype : filetypes) {
-				std::string url = BuildUrl(base_url, filename + "." + filetype);
+static const char *SniffName(SitemapSniff sniff) {
+	switch (sniff) {
+	case SitemapSniff::URLSET:
+		return "urlset";
+	case SitemapSniff::SITEMAPINDEX:
+		return "sitemapindex";
+	case SitemapSniff::URL_LIST:
+		return "url_list";
+	default:
+		return nullptr;
+	}
+}
 
-				auto response = HttpClient::Fetch(context, url, retry_config, user_agent);
+// Bind data for bruteforce_sitemaps()
+struct BruteforceScanBindData : public TableFunctionData {
+	std::vector<std::string> base_urls;
+	bool hits_only = false;
+};
 
-				// Check if we got a successful response with appropriate content type
-				if (response.success && response.status_code >= 200 && response.status_code < 300) {
-					std::string content_type_lower = response.content_type;
-					std::transform(content_type_lower.begin(), content_type_lower.end(),
-					              content_type_lower.begin(), ::tolower);
+// One output row of bruteforce_sitemaps()
+struct BruteforceProbeRow {
+	std::string base_url;
+	std::string url;
+	BruteforceProbe probe;
+	double latency_ms = 0;
+};
 
-					// Check for xml, gzip, or plain text content types
-					if (content_type_lower.find("xml") != std::string::npos ||
-					    content_type_lower.find("gzip") != std::string::npos ||
-					    content_type_lower.find("plain") != std::string::npos) {
-						found_url = url;
-						found = true;
-						break;
-					}
+// Global state for bruteforce_sitemaps(). Probe loops on the prober's FetchEngine work through every
+// candidate of every base URL and queue their rows; the scan emits them as they arrive.
+struct BruteforceScanGlobalState : public GlobalTableFunctionState {
+	BruteforceProber prober;
+	BruteforceChunkState sites;
+	std::mutex mutex;
+	std::condition_variable data_cv; // Row queued or all loops done
+	std::deque<BruteforceProbeRow> rows;
+	idx_t running_loops = 0;
+	std::atomic<bool> cancelled {false};
+
+	~BruteforceScanGlobalState() override {
+		// Scan finished early (e.g. LIMIT) - stop the probe loops before members go away
+		cancelled = true;
+		prober.engine.reset();
+	}
+};
+
+static unique_ptr<FunctionData> BruteforceScanBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<BruteforceScanBindData>();
+
+	std::vector<Value> urls;
+	auto &first_param = input.inputs[0];
+	if (first_param.IsNull()) {
+		throw InvalidInputException("bruteforce_sitemaps() requires a base_url argument");
+	}
+	if (first_param.type().id() == LogicalTypeId::LIST) {
+		urls = ListValue::GetChildren(first_param);
+		if (urls.empty()) {
+			throw InvalidInputException("bruteforce_sitemaps() requires at least one URL");
+		}
+	} else {
+		urls.push_back(first_param);
+	}
+	for (auto &url_value : urls) {
+		if (url_value.IsNull()) {
+			continue;
+		}
+		bind_data->base_urls.push_back(SiteBaseUrl("bruteforce_sitemaps", url_value.GetValue<std::string>()));
+	}
+
+	for (auto &kv : input.named_parameters) {
+		if (StringUtil::Lower(kv.first) == "hits_only") {
+			bind_data->hits_only = kv.second.GetValue<bool>();
+		}
+	}
+
+	names = {"base_url", "url", "status", "content_type", "bytes", "latency_ms", "sniff"};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::VARCHAR,
+	                LogicalType::BIGINT,  LogicalType::DOUBLE,  LogicalType::VARCHAR};
+	return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> BruteforceScanInitGlobal(ClientContext &context,
+                                                                     TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<BruteforceScanBindData>();
+	auto state = make_uniq<BruteforceScanGlobalState>();
+	InitProber(context, state->prober);
+
+	for (auto &base_url : bind_data.base_urls) {
+		state->prober.session->CheckSupported(base_url);
+		BruteforceRow site;
+		site.base_url = base_url;
+		site.site = make_uniq<BruteforceSite>();
+		state->sites.rows.push_back(std::move(site));
+	}
+
+	auto &state_ref = *state;
+	auto hits_only = bind_data.hits_only;
+	auto probe = [&state_ref, hits_only]() {
+		auto &prober = state_ref.prober;
+		auto &plan = *prober.plan;
+		auto &candidates = plan.Candidates();
+
+		RetryConfig retry_config;
+		retry_config.max_retries = 0; // No retries for bruteforce (too many URLs to check)
+		retry_config.is_cancelled = [&state_ref]() {
+			return state_ref.cancelled.load();
+		};
+
+		idx_t site_idx;
+		idx_t candidate_idx;
+		while (!state_ref.cancelled && state_ref.sites.Next(candidates.size(), site_idx, candidate_idx)) {
+			auto &site = state_ref.sites.rows[site_idx];
+			BruteforceProbeRow row;
+			row.base_url = site.base_url;
+			row.url = BuildUrl(site.base_url, candidates[candidate_idx]);
+			try {
+				auto start = std::chrono::steady_clock::now();
+				if (!RunCandidate(*prober.session, plan, site.base_url, *site.site, candidate_idx, retry_config,
+				                  row.probe)) {
+					continue; // Pruned or skipped on a catch-all site
 				}
+				row.latency_ms =
+				    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			} catch (std::exception &) {
+				// Reported like a network error
 			}
-
-			if (found) {
+			bool hit = row.probe.sniff != SitemapSniff::NONE;
+			if (state_ref.cancelled) {
 				break;
 			}
+			if (row.probe.status_code > 0) {
+				BruteforceStats::GetInstance().Record(candidates[candidate_idx], hit);
+			}
+			if (hits_only && !hit) {
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(state_ref.mutex);
+			state_ref.rows.push_back(std::move(row));
+			state_ref.data_cv.notify_one();
+		}
+
+		std::lock_guard<std::mutex> lock(state_ref.mutex);
+		state_ref.running_loops--;
+		if (state_ref.running_loops == 0) {
+			state_ref.data_cv.notify_all();
 		}
+	};
+
+	// One probe loop per request slot, as in bruteforce_find_sitemap()
+	auto &engine = *state->prober.engine;
+	auto probe_count = state->sites.rows.size() * state->prober.plan->Candidates().size();
+	auto loops = MinValue<idx_t>(engine.MaxInFlight(), probe_count);
+	state->running_loops = loops;
+	for (idx_t i = 0; i < loops; i++) {
+		engine.Submit(probe);
+	}
+	return std::move(state);
+}
+
+static void BruteforceScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<BruteforceScanGlobalState>();
+
+	std::unique_lock<std::mutex> lock(state.mutex);
+	while (state.rows.empty() && state.running_loops > 0) {
+		if (context.interrupted) {
+			throw InterruptException();
+		}
+		// A probe loop that died never decrements running_loops
+		state.prober.engine->ThrowIfFailed();
+		state.data_cv.wait_for(lock, std::chrono::milliseconds(100));
+	}
+
+	// Written straight into the flat vectors, like the sitemap_urls() scan
+	auto &base_url_vector = output.data[0];
+	auto &url_vector = output.data[1];
+	auto &status_vector = output.data[2];
+	auto &content_type_vector = output.data[3];
+	auto &sniff_vector = output.data[6];
+	auto base_url_data = FlatVector::GetData<string_t>(base_url_vector);
+	auto url_data = FlatVector::GetData<string_t>(url_vector);
+	auto status_data = FlatVector::GetData<int32_t>(status_vector);
+	auto content_type_data = FlatVector::GetData<string_t>(content_type_vector);
+	auto bytes_data = FlatVector::GetData<int64_t>(output.data[4]);
+	auto latency_data = FlatVector::GetData<double>(output.data[5]);
+	auto sniff_data = FlatVector::GetData<string_t>(sniff_vector);
 
-		if (found) {
-			result_data[i] = StringVector::AddString(result, found_url);
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && !state.rows.empty()) {
+		auto row = std::move(state.rows.front());
+		state.rows.pop_front();
+		auto &probe = row.probe;
+
+		base_url_data[count] = StringVector::AddString(base_url_vector, row.base_url);
+		url_data[count] = StringVector::AddString(url_vector, row.url);
+		if (probe.status_code > 0) {
+			status_data[count] = probe.status_code;
 		} else {
-			result_validity.SetInvalid(i);
+			FlatVector::SetNull(status_vector, count, true);
+		}
+		if (probe.content_type.empty()) {
+			FlatVector::SetNull(content_type_vector, count, true);
+		} else {
+			content_type_data[count] = StringVector::AddString(content_type_vector, probe.content_type);
 		}
+		bytes_data[count] = static_cast<int64_t>(probe.bytes);
+		latency_data[count] = row.latency_ms;
+		auto sniff = SniffName(probe.sniff);
+		if (sniff) {
+			sniff_data[count] = StringVector::AddString(sniff_vector, sniff);
+		} else {
+			FlatVector::SetNull(sniff_vector, count, true);
+		}
+		count++;
 	}
+	output.SetCardinality(count);
 }
 
 void RegisterBruteforceFunction(ExtensionLoader &loader) {
@@ -112,8 +675,20 @@ void RegisterBruteforceFunction(ExtensionLoader &loader) {
 		LogicalType::VARCHAR,
 		BruteforceFindSitemapFunction
 	);
+	bruteforce_func.init_local_state = BruteforceInitLocalState;
 
 	loader.RegisterFunction(bruteforce_func);
+
+	// Every probe (or every hit) of every candidate with timings, for a single URL or a list of URLs
+	TableFunction scan_func("bruteforce_sitemaps", {LogicalType::VARCHAR}, BruteforceScan, BruteforceScanBind,
+	                        BruteforceScanInitGlobal);
+	scan_func.named_parameters["hits_only"] = LogicalType::BOOLEAN;
+	loader.RegisterFunction(scan_func);
+
+	TableFunction scan_func_list("bruteforce_sitemaps", {LogicalType::LIST(LogicalType::VARCHAR)}, BruteforceScan,
+	                             BruteforceScanBind, BruteforceScanInitGlobal);
+	scan_func_list.named_parameters["hits_only"] = LogicalType::BOOLEAN;
+	loader.RegisterFunction(scan_func_list);
 }
 
 } // namespace duckdb
@@ -0,0 +1,199 @@
+#include "bruteforce_planner.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace duckdb {
+
+// File layout: a version line, then one "candidate<TAB>probes<TAB>hits" line per candidate
+static const char *STATS_FILE_MAGIC = "duckdb-sitemap-bruteforce-stats-v1";
+
+BruteforceStats &BruteforceStats::GetInstance() {
+	static BruteforceStats instance;
+	return instance;
+}
+
+void BruteforceStats::Record(const std::string &candidate, bool hit) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &entry = stats[candidate];
+	entry.probes++;
+	if (hit) {
+		entry.hits++;
+	}
+	version++;
+}
+
+void BruteforceStats::Get(const std::string &candidate, idx_t &probes, idx_t &hits) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = stats.find(candidate);
+	if (it == stats.end()) {
+		probes = 0;
+		hits = 0;
+		return;
+	}
+	probes = it->second.probes;
+	hits = it->second.hits;
+}
+
+std::vector<BruteforceCandidateStats> BruteforceStats::GetStats() {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<BruteforceCandidateStats> result;
+	for (auto &entry : stats) {
+		result.push_back(entry.second);
+		result.back().candidate = entry.first;
+	}
+	return result;
+}
+
+void BruteforceStats::Load(FileSystem &fs, const std::string &directory) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (loaded_directory == directory) {
+			return;
+		}
+		loaded_directory = directory;
+	}
+
+	std::string data;
+	try {
+		auto handle = fs.OpenFile(fs.JoinPath(directory, FILE_NAME),
+		                          FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (!handle) {
+			return;
+		}
+		data.resize(static_cast<size_t>(handle->GetFileSize()));
+		handle->Read(&data[0], data.size());
+	} catch (std::exception &) {
+		return;
+	}
+
+	auto lines = StringUtil::Split(data, '\n');
+	if (lines.empty() || lines[0] != STATS_FILE_MAGIC) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	for (idx_t i = 1; i < lines.size(); i++) {
+		auto fields = StringUtil::Split(lines[i], '\t');
+		if (fields.size() != 3) {
+			continue;
+		}
+		try {
+			auto &entry = stats[fields[0]];
+			entry.probes += std::stoull(fields[1]);
+			entry.hits += std::stoull(fields[2]);
+		} catch (std::exception &) {
+			continue;
+		}
+	}
+}
+
+void BruteforceStats::Save(FileSystem &fs, const std::string &directory) {
+	std::string data = std::string(STATS_FILE_MAGIC) + "\n";
+	idx_t data_version;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (version == saved_version) {
+			return;
+		}
+		data_version = version;
+		for (auto &entry : stats) {
+			data += entry.first + "\t" + std::to_string(entry.second.probes) + "\t" +
+			        std::to_string(entry.second.hits) + "\n";
+		}
+	}
+
+	// Write to a temporary file and rename, so a concurrent Load never sees a partial file
+	auto path = fs.JoinPath(directory, FILE_NAME);
+	auto temp_path = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	try {
+		if (!fs.DirectoryExists(directory)) {
+			fs.CreateDirectory(directory);
+		}
+		{
+			auto handle = fs.OpenFile(temp_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			handle->Write(&data[0], data.size());
+			handle->Close();
+		}
+		fs.MoveFile(temp_path, path);
+	} catch (std::exception &) {
+		// Still dirty - the next save tries again
+		try {
+			fs.TryRemoveFile(temp_path);
+		} catch (std::exception &) {
+		}
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	saved_version = MaxValue<idx_t>(saved_version, data_version);
+}
+
+BruteforcePlan::BruteforcePlan(const std::vector<std::string> &candidates_p,
+                               const std::vector<std::string> &common_candidates, BruteforceStats &stats) {
+	// Smoothed hit rate: observed probes and hits plus PRIOR_WEIGHT probes at the prior rate
+	std::vector<std::pair<double, idx_t>> ranking;
+	for (idx_t i = 0; i < candidates_p.size(); i++) {
+		idx_t probes;
+		idx_t hits;
+		stats.Get(candidates_p[i], probes, hits);
+		double prior = PRIOR_HIT_RATE / static_cast<double>(1 + i);
+		double score =
+		    (static_cast<double>(hits) + PRIOR_WEIGHT * prior) / (static_cast<double>(probes) + PRIOR_WEIGHT);
+		ranking.emplace_back(score, i);
+	}
+	std::stable_sort(ranking.begin(), ranking.end(),
+	                 [](const std::pair<double, idx_t> &a, const std::pair<double, idx_t> &b) {
+		                 return a.first > b.first;
+	                 });
+	std::unordered_set<std::string> common_set(common_candidates.begin(), common_candidates.end());
+	for (auto &entry : ranking) {
+		candidates.push_back(candidates_p[entry.second]);
+		common.push_back(common_set.count(candidates.back()) > 0);
+	}
+
+	// Directory prefixes of every candidate, and how many candidates each one holds
+	std::vector<std::vector<std::string>> prefixes(candidates.size());
+	std::unordered_map<std::string, idx_t> counts;
+	for (idx_t i = 0; i < candidates.size(); i++) {
+		auto &candidate = candidates[i];
+		for (auto pos = candidate.find('/'); pos != std::string::npos; pos = candidate.find('/', pos + 1)) {
+			prefixes[i].push_back(candidate.substr(0, pos + 1));
+			counts[prefixes[i].back()]++;
+		}
+	}
+	directories.resize(candidates.size());
+	for (idx_t i = 0; i < candidates.size(); i++) {
+		for (auto &prefix : prefixes[i]) {
+			if (counts[prefix] >= MIN_PRUNABLE_CANDIDATES) {
+				directories[i].push_back(prefix);
+			}
+		}
+	}
+}
+
+bool DirectoryPruner::IsAbsent(const std::string &directory, const std::function<bool()> &probe) {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto it = states.find(directory);
+		if (it != states.end()) {
+			cv.wait(lock, [&]() { return states[directory] != State::PENDING; });
+			return states[directory] == State::ABSENT;
+		}
+		states[directory] = State::PENDING;
+	}
+
+	bool absent = false;
+	try {
+		absent = probe();
+	} catch (std::exception &) {
+		// Not a proof of absence
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	states[directory] = absent ? State::ABSENT : State::PRESENT;
+	cv.notify_all();
+	return absent;
+}
+
+} // namespace duckdb
@@ -0,0 +1,162 @@
+#include "diagnostics_function.hpp"
+#include "bruteforce_planner.hpp"
+#include "host_scheduler.hpp"
+#include "sitemap_cache.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Global state for sitemap_host_stats() - a snapshot taken at init
+struct HostStatsGlobalState : public GlobalTableFunctionState {
+	std::vector<HostStats> stats;
+	idx_t current_idx = 0;
+};
+
+static unique_ptr<FunctionData> HostStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"host", "in_flight", "queued", "requests", "crawl_delay"};
+	return_types = {LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT,
+	                LogicalType::DOUBLE};
+	return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> HostStatsInitGlobal(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	auto state = make_uniq<HostStatsGlobalState>();
+	state->stats = HostScheduler::GetInstance().GetStats();
+	return std::move(state);
+}
+
+static void HostStatsScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<HostStatsGlobalState>();
+
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && state.current_idx < state.stats.size()) {
+		auto &stats = state.stats[state.current_idx];
+
+		output.SetValue(0, count, Value(stats.host));
+		output.SetValue(1, count, Value::BIGINT(static_cast<int64_t>(stats.in_flight)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(stats.queued)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(stats.requests)));
+		output.SetValue(4, count, Value::DOUBLE(stats.crawl_delay));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+// Global state for the single-row cache functions
+struct CacheFunctionGlobalState : public GlobalTableFunctionState {
+	bool finished = false;
+};
+
+static unique_ptr<FunctionData> CacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"entries", "negative_entries", "memory_bytes", "memory_limit", "hits",
+	         "negative_hits", "misses", "evictions", "expirations"};
+	return_types = vector<LogicalType>(names.size(), LogicalType::BIGINT);
+	return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> CacheFunctionInitGlobal(ClientContext &context,
+                                                                    TableFunctionInitInput &input) {
+	return make_uniq<CacheFunctionGlobalState>();
+}
+
+static void CacheStatsScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<CacheFunctionGlobalState>();
+	if (state.finished) {
+		return;
+	}
+	state.finished = true;
+
+	auto stats = SitemapCache::GetInstance().GetStats();
+	idx_t values[] = {stats.entries, stats.negative_entries, stats.memory_bytes,
+	                  stats.memory_limit, stats.hits, stats.negative_hits,
+	                  stats.misses, stats.evictions, stats.expirations};
+	for (idx_t col = 0; col < output.ColumnCount(); col++) {
+		output.SetValue(col, 0, Value::BIGINT(static_cast<int64_t>(values[col])));
+	}
+	output.SetCardinality(1);
+}
+
+static unique_ptr<FunctionData> CacheClearBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"removed"};
+	return_types = {LogicalType::BIGINT};
+	return make_uniq<TableFunctionData>();
+}
+
+static void CacheClearScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<CacheFunctionGlobalState>();
+	if (state.finished) {
+		return;
+	}
+	state.finished = true;
+
+	auto removed = SitemapCache::GetInstance().Clear();
+	output.SetValue(0, 0, Value::BIGINT(static_cast<int64_t>(removed)));
+	output.SetCardinality(1);
+}
+
+// Global state for sitemap_bruteforce_stats() - a snapshot taken at init
+struct BruteforceStatsGlobalState : public GlobalTableFunctionState {
+	std::vector<BruteforceCandidateStats> stats;
+	idx_t current_idx = 0;
+};
+
+static unique_ptr<FunctionData> BruteforceStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"candidate", "probes", "hits", "hit_rate"};
+	return_types = {LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::DOUBLE};
+	return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> BruteforceStatsInitGlobal(ClientContext &context,
+                                                                      TableFunctionInitInput &input) {
+	auto state = make_uniq<BruteforceStatsGlobalState>();
+	state->stats = BruteforceStats::GetInstance().GetStats();
+	return std::move(state);
+}
+
+static void BruteforceStatsScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<BruteforceStatsGlobalState>();
+
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && state.current_idx < state.stats.size()) {
+		auto &stats = state.stats[state.current_idx];
+
+		output.SetValue(0, count, Value(stats.candidate));
+		output.SetValue(1, count, Value::BIGINT(static_cast<int64_t>(stats.probes)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(stats.hits)));
+		output.SetValue(3, count, Value::DOUBLE(static_cast<double>(stats.hits) / static_cast<double>(stats.probes)));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+void RegisterDiagnosticsFunctions(ExtensionLoader &loader) {
+	// Per-host politeness scheduler state: requests in flight, requests waiting for a permit
+	TableFunction host_stats_func("sitemap_host_stats", {}, HostStatsScan, HostStatsBind, HostStatsInitGlobal);
+	loader.RegisterFunction(host_stats_func);
+
+	// Discovery cache: size, hit rates, evictions; and a way to drop it
+	TableFunction cache_stats_func("sitemap_cache_stats", {}, CacheStatsScan, CacheStatsBind,
+	                               CacheFunctionInitGlobal);
+	loader.RegisterFunction(cache_stats_func);
+
+	TableFunction cache_clear_func("sitemap_cache_clear", {}, CacheClearScan, CacheClearBind, CacheFunctionInitGlobal);
+	loader.RegisterFunction(cache_clear_func);
+
+	// Observed hit rates of bruteforce candidates, which rank the probe order
+	TableFunction bruteforce_stats_func("sitemap_bruteforce_stats", {}, BruteforceStatsScan, BruteforceStatsBind,
+	                                    BruteforceStatsInitGlobal);
+	loader.RegisterFunction(bruteforce_stats_func);
+}
+
+} // namespace duckdb
@@ -0,0 +1,121 @@
+#include "fetch_engine.hpp"
+
+namespace duckdb {
+
+FetchEngine::FetchEngine(idx_t max_in_flight_p) : max_in_flight(max_in_flight_p == 0 ? 1 : max_in_flight_p) {
+}
+
+FetchEngine::~FetchEngine() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		shutdown = true;
+		tasks.clear();
+	}
+	task_cv.notify_all();
+	for (auto &worker : workers) {
+		worker.join();
+	}
+}
+
+void FetchEngine::Submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+
+		// Spawn workers lazily - a single sitemap should not start max_in_flight threads
+		idx_t idle_workers = workers.size() - running;
+		if (idle_workers < tasks.size() && workers.size() < max_in_flight) {
+			workers.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+	task_cv.notify_one();
+}
+
+void FetchEngine::Wait() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		idle_cv.wait(lock, [this]() { return tasks.empty() && running == 0; });
+	}
+	ThrowIfFailed();
+}
+
+void FetchEngine::ThrowIfFailed() {
+	ErrorData task_error;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task_error = error;
+	}
+	if (task_error.HasError()) {
+		task_error.Throw();
+	}
+}
+
+void FetchEngine::WorkerLoop() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		task_cv.wait(lock, [this]() { return shutdown || !tasks.empty(); });
+		if (shutdown) {
+			return;
+		}
+		auto task = std::move(tasks.front());
+		tasks.pop_front();
+		running++;
+
+		lock.unlock();
+		// An escaping exception must not take the worker down; keep the first one for Wait()
+		ErrorData task_error;
+		try {
+			task();
+		} catch (std::exception &ex) {
+			task_error = ErrorData(ex);
+		} catch (...) {
+			task_error = ErrorData(ExceptionType::UNKNOWN_TYPE, "Unknown exception in fetch task");
+		}
+		lock.lock();
+		if (task_error.HasError() && !error.HasError()) {
+			error = std::move(task_error);
+		}
+
+		running--;
+		if (tasks.empty() && running == 0) {
+			idle_cv.notify_all();
+		}
+	}
+}
+
+PriorityResolver::PriorityResolver(idx_t count)
+    : outcomes(count, Outcome::PENDING), best_success(DConstants::INVALID_INDEX), winner(DConstants::INVALID_INDEX) {
+}
+
+bool PriorityResolver::Report(idx_t idx, bool success) {
+	std::lock_guard<std::mutex> lock(mutex);
+	outcomes[idx] = success ? Outcome::SUCCESS : Outcome::FAILURE;
+	if (success && idx < best_success) {
+		best_success = idx;
+	}
+	if (decided) {
+		return false;
+	}
+
+	// Walk in precedence order: the first success wins once nothing before it is pending. Failures
+	// before the cursor are final, so every outcome is stepped over once.
+	for (; next_undecided < outcomes.size(); next_undecided++) {
+		if (outcomes[next_undecided] == Outcome::PENDING) {
+			return false;
+		}
+		if (outcomes[next_undecided] == Outcome::SUCCESS) {
+			winner = next_undecided;
+			decided = true;
+			return true;
+		}
+	}
+	decided = true;
+	return true;
+}
+
+idx_t PriorityResolver::Winner() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return winner;
+}
+
+} // namespace duckdb
@@ -0,0 +1,156 @@
+#include "host_scheduler.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace duckdb {
+
+constexpr std::chrono::minutes HostScheduler::IDLE_HOST_TIMEOUT;
+constexpr std::chrono::milliseconds HostScheduler::CANCEL_POLL_INTERVAL;
+constexpr std::chrono::minutes HostScheduler::PRUNE_INTERVAL;
+
+HostScheduler::Permit::Permit(HostScheduler &scheduler_p, std::string host_p)
+    : scheduler(scheduler_p), host(std::move(host_p)) {
+}
+
+HostScheduler::Permit::~Permit() {
+	scheduler.Release(host);
+}
+
+HostScheduler &HostScheduler::GetInstance() {
+	static HostScheduler instance;
+	return instance;
+}
+
+std::string HostScheduler::ExtractHost(const std::string &url) {
+	size_t start = url.find("://");
+	start = start == std::string::npos ? 0 : start + 3;
+	size_t end = url.find_first_of("/?#", start);
+	std::string host = url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+	// Drop userinfo - the port stays, different ports are different servers
+	auto at = host.rfind('@');
+	if (at != std::string::npos) {
+		host = host.substr(at + 1);
+	}
+	std::transform(host.begin(), host.end(), host.begin(), [](unsigned char c) { return std::tolower(c); });
+	return host;
+}
+
+HostScheduler::HostState &HostScheduler::GetHostState(const std::string &host) {
+	auto &entry = hosts[host];
+	if (!entry) {
+		entry = make_uniq<HostState>();
+	}
+	return *entry;
+}
+
+void HostScheduler::PruneIdleHosts(std::chrono::steady_clock::time_point now) {
+	if (now - last_prune < PRUNE_INTERVAL) {
+		return;
+	}
+	last_prune = now;
+	for (auto it = hosts.begin(); it != hosts.end();) {
+		auto &state = *it->second;
+		if (state.in_flight == 0 && state.queued == 0 && now - state.last_used >= IDLE_HOST_TIMEOUT) {
+			it = hosts.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+unique_ptr<HostScheduler::Permit> HostScheduler::Acquire(const std::string &host, const HostLimits &limits,
+                                                         const std::function<bool()> &is_cancelled) {
+	std::unique_lock<std::mutex> lock(mutex);
+	PruneIdleHosts(std::chrono::steady_clock::now());
+	auto &state = GetHostState(host);
+	state.queued++;
+
+	while (true) {
+		// Effective rate: the stricter of the configured rate and the robots.txt Crawl-delay
+		double rate = limits.requests_per_second;
+		if (state.crawl_delay > 0) {
+			double delay_rate = 1.0 / state.crawl_delay;
+			rate = rate > 0 ? std::min(rate, delay_rate) : delay_rate;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (rate > 0) {
+			// Burst of one second worth of requests, but never less than one token
+			double capacity = std::max(1.0, rate);
+			double elapsed = std::chrono::duration<double>(now - state.last_refill).count();
+			state.tokens = std::min(capacity, state.tokens + elapsed * rate);
+		}
+		state.last_refill = now;
+
+		bool has_slot = limits.max_concurrency == 0 || state.in_flight < limits.max_concurrency;
+		bool has_token = rate <= 0 || state.tokens >= 1;
+		if (has_slot && has_token) {
+			if (rate > 0) {
+				state.tokens -= 1;
+			}
+			state.queued--;
+			state.in_flight++;
+			state.requests++;
+			state.last_used = now;
+			return make_uniq<Permit>(*this, host);
+		}
+		if (is_cancelled && is_cancelled()) {
+			state.queued--;
+			state.last_used = now;
+			return nullptr;
+		}
+
+		// Woken by Release without a slot, otherwise sleep until the next token is due. A cancellable
+		// waiter wakes up regularly to check its hook.
+		auto wait = std::chrono::steady_clock::duration::max();
+		if (has_slot) {
+			wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			    std::chrono::duration<double>((1 - state.tokens) / rate));
+		}
+		if (is_cancelled) {
+			wait = std::min<std::chrono::steady_clock::duration>(wait, CANCEL_POLL_INTERVAL);
+		}
+		if (wait == std::chrono::steady_clock::duration::max()) {
+			state.cv.wait(lock);
+		} else {
+			state.cv.wait_for(lock, wait);
+		}
+	}
+}
+
+void HostScheduler::Release(const std::string &host) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &state = GetHostState(host);
+	state.in_flight--;
+	state.last_used = std::chrono::steady_clock::now();
+	state.cv.notify_all();
+}
+
+void HostScheduler::SetCrawlDelay(const std::string &host, double seconds) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &state = GetHostState(host);
+	state.crawl_delay = std::max(0.0, seconds);
+	state.tokens = std::min(state.tokens, 1.0);
+	state.cv.notify_all();
+}
+
+std::vector<HostStats> HostScheduler::GetStats() {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<HostStats> result;
+	result.reserve(hosts.size());
+	for (auto &entry : hosts) {
+		HostStats stats;
+		stats.host = entry.first;
+		stats.in_flight = entry.second->in_flight;
+		stats.queued = entry.second->queued;
+		stats.requests = entry.second->requests;
+		stats.crawl_delay = entry.second->crawl_delay;
+		result.push_back(std::move(stats));
+	}
+	std::sort(result.begin(), result.end(),
+	          [](const HostStats &a, const HostStats &b) { return a.host < b.host; });
+	return result;
+}
+
+} // namespace duckdb
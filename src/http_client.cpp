@@ -1,10 +1,19 @@
 #include "http_client.hpp"
+#include "request_coalescer.hpp"
 #include "duckdb/main/connection.hpp"
+#include "duckdb/main/prepared_statement.hpp"
+#include "duckdb/main/extension_helper.hpp"
+#include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 namespace duckdb {
 
@@ -40,41 +49,349 @@ int HttpClient::ParseRetryAfter(const std::string &retry_after) {
 	}
 }
 
-HttpResponse HttpClient::ExecuteHttpGet(DatabaseInstance &db, const std::string &url, const std::string &user_agent) {
+shared_ptr<HttpConnectionPool> HttpConnectionPool::Get(ClientContext &context) {
+	return context.registered_state->GetOrCreate<HttpConnectionPool>("sitemap_http_connection_pool");
+}
+
+unique_ptr<HTTPClient> HttpConnectionPool::Acquire(const std::string &proto_host_port) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = idle_connections.find(proto_host_port);
+	if (it == idle_connections.end() || it->second.empty()) {
+		return nullptr;
+	}
+	auto client = std::move(it->second.back());
+	it->second.pop_back();
+	return client;
+}
+
+void HttpConnectionPool::Release(const std::string &proto_host_port, unique_ptr<HTTPClient> client) {
+	if (!client) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &idle = idle_connections[proto_host_port];
+	if (idle.size() < MAX_IDLE_CONNECTIONS_PER_HOST) {
+		idle.push_back(std::move(client));
+	}
+}
+
+HttpSession::HttpSession(ClientContext &context, std::string user_agent_p)
+    : db(DatabaseInstance::GetDatabase(context)), fs(FileSystem::GetFileSystem(context)),
+      user_agent(std::move(user_agent_p)) {
+	Value limit_value;
+	if (context.TryGetCurrentSetting("sitemap_max_host_concurrency", limit_value)) {
+		host_limits.max_concurrency = static_cast<idx_t>(limit_value.GetValue<int64_t>());
+	}
+	if (context.TryGetCurrentSetting("sitemap_max_host_rps", limit_value)) {
+		host_limits.requests_per_second = limit_value.GetValue<double>();
+	}
+
+	Value backend_value;
+	if (context.TryGetCurrentSetting("sitemap_http_backend", backend_value) &&
+	    StringUtil::Lower(backend_value.GetValue<std::string>()) == "http_request") {
+		backend = HttpBackend::HTTP_REQUEST;
+		// http_request settings (proxy, timeouts) are per connection, so are its shared responses
+		cache_identity = user_agent + "\n";
+		identity = "http_request\n" + std::to_string(reinterpret_cast<uintptr_t>(&context)) + "\n" + cache_identity;
+		return;
+	}
+
+	// The built-in HTTPUtil only speaks plain HTTP; httpfs replaces it with a TLS-capable client
+	if (!db.ExtensionIsLoaded("httpfs")) {
+		ExtensionHelper::TryAutoLoadExtension(context, "httpfs");
+	}
+	https_supported = db.ExtensionIsLoaded("httpfs");
+	auto &http_util = HTTPUtil::Get(db);
+	http_params = http_util.InitializeParameters(context, "");
+	// HttpClient::Fetch owns retries and backoff
+	http_params->retries = 0;
+	pool = HttpConnectionPool::Get(context);
+
+	// Everything besides the request itself that can change the response: the database's HTTP client,
+	// the proxy and the extra headers configured for this connection
+	cache_identity = user_agent + "\n" + http_params->http_proxy + ":" + std::to_string(http_params->http_proxy_port) +
+	                 "\n" + http_params->http_proxy_username + "\n" + http_params->http_proxy_password + "\n";
+	std::map<std::string, std::string> extra_headers(http_params->extra_headers.begin(),
+	                                                 http_params->extra_headers.end());
+	for (auto &header : extra_headers) {
+		cache_identity += header.first + ": " + header.second + "\n";
+	}
+	identity = "native\n" + std::to_string(reinterpret_cast<uintptr_t>(&db)) + "\n" + cache_identity;
+}
+
+static constexpr const char *FILE_URL_PREFIX = "file://";
+
+bool HttpSession::IsFileUrl(const std::string &url) {
+	return StringUtil::StartsWith(url, FILE_URL_PREFIX);
+}
+
+static bool IsHttpsUrl(const std::string &url) {
+	return StringUtil::StartsWith(StringUtil::Lower(url.substr(0, 8)), "https://");
+}
+
+static std::string HttpsUnsupportedMessage(const std::string &url) {
+	return "Cannot fetch " + url +
+	       ": HTTPS requires the httpfs extension, which could not be loaded. Run INSTALL httpfs; LOAD httpfs; "
+	       "or SET sitemap_http_backend = 'http_request'";
+}
+
+void HttpSession::CheckSupported(const std::string &url) const {
+	if (backend == HttpBackend::NATIVE && !https_supported && IsHttpsUrl(url)) {
+		throw MissingExtensionException(HttpsUnsupportedMessage(url));
+	}
+}
+
+HttpResponse HttpSession::Request(const std::string &url, const HttpRequestOptions &options) {
+	if (IsFileUrl(url)) {
+		return FileRequest(url, options);
+	}
+	if (backend == HttpBackend::HTTP_REQUEST) {
+		return HttpRequestQuery(url, options);
+	}
+	return NativeRequest(url, options);
+}
+
+static int64_t ParseContentLength(const std::string &value) {
+	try {
+		return std::stoll(value);
+	} catch (...) {
+		return -1;
+	}
+}
+
+static void CopyResponseHeaders(const HTTPResponse &http_response, HttpResponse &response) {
+	response.status_code = static_cast<int>(http_response.status);
+	if (http_response.headers.HasHeader("Content-Type")) {
+		response.content_type = http_response.headers.GetHeaderValue("Content-Type");
+	}
+	if (http_response.headers.HasHeader("Retry-After")) {
+		response.retry_after = http_response.headers.GetHeaderValue("Retry-After");
+	}
+	if (http_response.headers.HasHeader("ETag")) {
+		response.etag = http_response.headers.GetHeaderValue("ETag");
+	}
+	if (http_response.headers.HasHeader("Last-Modified")) {
+		response.last_modified = http_response.headers.GetHeaderValue("Last-Modified");
+	}
+	if (http_response.headers.HasHeader("Content-Length")) {
+		response.content_length = ParseContentLength(http_response.headers.GetHeaderValue("Content-Length"));
+	}
+}
+
+// A local file answers like a server without validators: 200 with the file, 404 if there is none
+HttpResponse HttpSession::FileRequest(const std::string &url, const HttpRequestOptions &options) {
 	HttpResponse response;
+	auto path = url.substr(strlen(FILE_URL_PREFIX));
+	try {
+		unique_ptr<FileHandle> handle;
+		if (!fs.DirectoryExists(path)) {
+			handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		}
+		if (!handle) {
+			response.status_code = 404;
+			response.error = "HTTP 404";
+			return response;
+		}
+		auto file_size = static_cast<idx_t>(handle->GetFileSize());
+		response.content_length = static_cast<int64_t>(file_size);
+		if (options.method == HttpMethod::GET) {
+			auto read_size = file_size;
+			if (options.max_body_bytes > 0 && read_size > options.max_body_bytes) {
+				read_size = options.max_body_bytes;
+				response.truncated = true;
+			}
+			response.body.resize(read_size);
+			if (read_size > 0) {
+				handle->Read(&response.body[0], read_size);
+			}
+		}
+	} catch (std::exception &ex) {
+		ErrorData error(ex);
+		response.error = error.RawMessage();
+		return response;
+	}
+	response.status_code = 200;
+	response.success = true;
+	return response;
+}
+
+HttpResponse HttpSession::NativeRequest(const std::string &url, const HttpRequestOptions &options) {
+	HttpResponse response;
+	if (!https_supported && IsHttpsUrl(url)) {
+		// E.g. an https:// child sitemap of a plain HTTP index
+		response.error = HttpsUnsupportedMessage(url);
+		return response;
+	}
 
-	Connection conn(db);
+	std::string path;
+	std::string proto_host_port;
+	HTTPUtil::DecomposeURL(url, path, proto_host_port);
 
-	// Load http_request in this connection
-	auto load_result = conn.Query("LOAD http_request");
+	auto &http_util = HTTPUtil::Get(db);
+	auto client = pool->Acquire(proto_host_port);
+
+	HTTPHeaders headers;
+	if (!user_agent.empty()) {
+		headers.Insert("User-Agent", user_agent);
+	}
+	for (auto &header : options.headers) {
+		headers.Insert(header.first, header.second);
+	}
+
+	// Headers of the response whose body is being read, for when the read is aborted
+	HttpResponse head;
+	auto max_body_bytes = options.max_body_bytes;
+
+	unique_ptr<HTTPResponse> http_response;
+	try {
+		if (options.method == HttpMethod::HEAD) {
+			HeadRequestInfo head_request(proto_host_port, path, headers, *http_params);
+			http_response = http_util.Request(head_request, client);
+		} else {
+			// Stream the body straight into the response instead of going through a VARCHAR
+			GetRequestInfo get_request(
+			    proto_host_port, path, headers, *http_params,
+			    [&](const HTTPResponse &http_head) {
+				    CopyResponseHeaders(http_head, head);
+				    return true;
+			    },
+			    [&](const_data_ptr_t data, idx_t data_length) {
+				    response.body.append(const_char_ptr_cast(data), data_length);
+				    if (max_body_bytes > 0 && response.body.size() >= max_body_bytes) {
+					    // Enough of the body - abort the transfer
+					    response.body.resize(max_body_bytes);
+					    response.truncated = true;
+					    return false;
+				    }
+				    return true;
+			    });
+			http_response = http_util.Request(get_request, client);
+		}
+	} catch (std::exception &ex) {
+		// Connection is in an unknown state - do not return it to the pool
+		if (!response.truncated) {
+			ErrorData error(ex);
+			response.error = error.RawMessage();
+			return response;
+		}
+		// Aborting a capped read throws; the headers and body prefix received so far are the response
+	}
+
+	if (response.truncated) {
+		// The aborted transfer surfaces as an exception or a request error; either way the connection
+		// still has unread body data and is dropped
+		auto body = std::move(response.body);
+		response = std::move(head);
+		response.body = std::move(body);
+		response.truncated = true;
+	} else {
+		if (!http_response) {
+			response.error = "No response from HTTP request";
+			return response;
+		}
+		if (http_response->HasRequestError()) {
+			response.error = http_response->GetRequestError();
+			return response;
+		}
+		CopyResponseHeaders(*http_response, response);
+		pool->Release(proto_host_port, std::move(client));
+	}
+
+	response.success = (response.status_code >= 200 && response.status_code < 300);
+	if (!response.success) {
+		response.error = "HTTP " + std::to_string(response.status_code);
+	}
+	return response;
+}
+
+HttpSession::ThreadConnection &HttpSession::GetThreadConnection() {
+	std::lock_guard<std::mutex> lock(connections_mutex);
+	auto &entry = connections[std::this_thread::get_id()];
+	if (entry) {
+		return *entry;
+	}
+	entry = make_uniq<ThreadConnection>();
+	entry->conn = make_uniq<Connection>(db);
+
+	// Load http_request once per connection instead of once per request. The extension is only installed
+	// here, on first use of this backend, so LOAD sitemap itself never needs the network.
+	auto load_result = entry->conn->Query("LOAD http_request");
 	if (load_result->HasError()) {
-		response.error = "Failed to load http_request: " + load_result->GetError();
+		static const std::string MISSING = "sitemap_http_backend 'http_request' requires the http_request extension. ";
+		auto install_result = entry->conn->Query("INSTALL http_request FROM community");
+		if (install_result->HasError()) {
+			entry->error = MISSING + "Failed to install: " + install_result->GetError();
+			return *entry;
+		}
+		load_result = entry->conn->Query("LOAD http_request");
+		if (load_result->HasError()) {
+			entry->error = MISSING + "Failed to load: " + load_result->GetError();
+		}
+	}
+	return *entry;
+}
+
+PreparedStatement &HttpSession::GetStatement(ThreadConnection &thread_conn, const HttpRequestOptions &options) {
+	auto &headers = options.headers;
+	std::string key = options.method == HttpMethod::HEAD ? "HEAD\n" : "GET\n";
+	for (auto &header : headers) {
+		key += header.first + "\n";
+	}
+	auto &statement = thread_conn.statements[key];
+	if (statement) {
+		return *statement;
+	}
+
+	// Prepare once per header set - $1 is the URL, header values follow in name order
+	vector<std::string> header_params;
+	idx_t param_idx = 2;
+	if (!user_agent.empty()) {
+		header_params.push_back("'User-Agent': $" + std::to_string(param_idx++));
+	}
+	for (auto &header : headers) {
+		header_params.push_back(KeywordHelper::WriteQuoted(header.first, '\'') + ": $" + std::to_string(param_idx++));
+	}
+	std::string query = "SELECT status, decode(body) AS body, "
+	                    "content_type, "
+	                    "headers['retry-after'] AS retry_after, "
+	                    "headers['etag'] AS etag, "
+	                    "headers['last-modified'] AS last_modified, "
+	                    "headers['content-length'] AS content_length "
+	                    "FROM ";
+	query += options.method == HttpMethod::HEAD ? "http_head($1" : "http_get($1";
+	if (!header_params.empty()) {
+		query += ", headers := {" + StringUtil::Join(header_params, ", ") + "}";
+	}
+	query += ")";
+	statement = thread_conn.conn->Prepare(query);
+	return *statement;
+}
+
+HttpResponse HttpSession::HttpRequestQuery(const std::string &url, const HttpRequestOptions &options) {
+	HttpResponse response;
+
+	auto &thread_conn = GetThreadConnection();
+	if (!thread_conn.error.empty()) {
+		response.error = thread_conn.error;
 		return response;
 	}
 
-	// Escape URL for SQL
-	std::string escaped_url = StringUtil::Replace(url, "'", "''");
+	auto &statement = GetStatement(thread_conn, options);
+	if (statement.HasError()) {
+		response.error = "Failed to prepare http_get: " + statement.GetError();
+		return response;
+	}
 
-	// Build query - request headers to get Retry-After
-	std::string query;
+	vector<Value> params;
+	params.emplace_back(url);
 	if (!user_agent.empty()) {
-		std::string escaped_ua = StringUtil::Replace(user_agent, "'", "''");
-		query = StringUtil::Format(
-		    "SELECT status, decode(body) AS body, "
-		    "content_type, "
-		    "headers['retry-after'] AS retry_after "
-		    "FROM http_get('%s', headers := {'User-Agent': '%s'})",
-		    escaped_url, escaped_ua);
-	} else {
-		query = StringUtil::Format(
-		    "SELECT status, decode(body) AS body, "
-		    "content_type, "
-		    "headers['retry-after'] AS retry_after "
-		    "FROM http_get('%s')",
-		    escaped_url);
+		params.emplace_back(user_agent);
+	}
+	for (auto &header : options.headers) {
+		params.emplace_back(header.second);
 	}
 
-	auto result = conn.Query(query);
+	auto result = statement.Execute(params, false);
 
 	if (result->HasError()) {
 		response.error = result->GetError();
@@ -96,6 +413,11 @@ HttpResponse HttpClient::ExecuteHttpGet(DatabaseInstance &db, const std::string
 	// Get body
 	auto body_val = chunk->GetValue(1, 0);
 	response.body = body_val.IsNull() ? "" : body_val.GetValue<std::string>();
+	if (options.max_body_bytes > 0 && response.body.size() > options.max_body_bytes) {
+		// http_get has already downloaded everything; only the copy is saved
+		response.body.resize(options.max_body_bytes);
+		response.truncated = true;
+	}
 
 	// Get content-type
 	auto ct_val = chunk->GetValue(2, 0);
@@ -105,16 +427,53 @@ HttpResponse HttpClient::ExecuteHttpGet(DatabaseInstance &db, const std::string
 	auto ra_val = chunk->GetValue(3, 0);
 	response.retry_after = ra_val.IsNull() ? "" : ra_val.GetValue<std::string>();
 
+	// Get cache validators
+	auto etag_val = chunk->GetValue(4, 0);
+	response.etag = etag_val.IsNull() ? "" : etag_val.GetValue<std::string>();
+	auto lm_val = chunk->GetValue(5, 0);
+	response.last_modified = lm_val.IsNull() ? "" : lm_val.GetValue<std::string>();
+	auto cl_val = chunk->GetValue(6, 0);
+	response.content_length = cl_val.IsNull() ? -1 : ParseContentLength(cl_val.GetValue<std::string>());
+
 	response.success = (response.status_code >= 200 && response.status_code < 300);
+	if (!response.success) {
+		response.error = "HTTP " + std::to_string(response.status_code);
+	}
 	return response;
 }
 
-HttpResponse HttpClient::Fetch(ClientContext &context, const std::string &url, const RetryConfig &config,
-                               const std::string &user_agent) {
-	auto &db = DatabaseInstance::GetDatabase(context);
+HttpResponse HttpClient::Fetch(HttpSession &session, const std::string &url, const RetryConfig &config,
+                               const HttpRequestOptions &options) {
+	// Local reads need neither politeness, coalescing nor retries
+	if (HttpSession::IsFileUrl(url)) {
+		return session.Request(url, options);
+	}
+	auto &scheduler = HostScheduler::GetInstance();
+	auto &coalescer = RequestCoalescer::GetInstance();
+	auto host = HostScheduler::ExtractHost(url);
+	auto key = RequestCoalescer::MakeKey(url, session.Identity(), options);
 
 	for (int attempt = 0; attempt <= config.max_retries; attempt++) {
-		auto response = ExecuteHttpGet(db, url, user_agent);
+		HttpResponse response;
+		if (config.is_cancelled && config.is_cancelled()) {
+			response.error = "Request cancelled: " + url;
+			return response;
+		}
+		// Concurrent identical attempts, from any thread or query, share one request. Retries and
+		// backoff stay with each caller, so every caller keeps its own retry policy.
+		auto attempted = coalescer.Run(key, config.is_cancelled, response, [&](HttpResponse &result) {
+			// Hold the host permit only for the request itself, not for the backoff below
+			auto permit = scheduler.Acquire(host, session.Limits(), config.is_cancelled);
+			if (!permit) {
+				return false;
+			}
+			result = session.Request(url, options);
+			return true;
+		});
+		if (!attempted) {
+			response.error = "Request cancelled: " + url;
+			return response;
+		}
 
 		if (response.success) {
 			return response;
@@ -154,8 +513,20 @@ HttpResponse HttpClient::Fetch(ClientContext &context, const std::string &url, c
 			wait_ms += (std::rand() % (2 * jitter)) - jitter;
 		}
 
-		// Wait before retry
-		std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms));
+		// Wait before retry, in slices so a caller that no longer needs the response stops waiting
+		auto retry_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(wait_ms);
+		while (true) {
+			if (config.is_cancelled && config.is_cancelled()) {
+				response.error = "Request cancelled: " + url;
+				return response;
+			}
+			auto now = std::chrono::steady_clock::now();
+			if (now >= retry_at) {
+				break;
+			}
+			auto slice = config.is_cancelled ? std::chrono::milliseconds(50) : std::chrono::milliseconds(wait_ms);
+			std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(retry_at - now, slice));
+		}
 	}
 
 	// Should not reach here
@@ -9,6 +9,10 @@ class BruteforceFinder {
 public:
 	static std::vector<std::string> GetFilenames();
 	static std::vector<std::string> GetFiletypes();
+	// Well-known sitemap paths (CMS and SEO plugin defaults), tried before the generated patterns
+	static std::vector<std::string> GetCommonCandidates();
+	// Candidate paths in built-in order: the common ones, then every filename.filetype, without duplicates
+	static std::vector<std::string> GetCandidates();
 };
 
 } // namespace duckdb
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace duckdb {
+
+class FileSystem;
+
+struct BruteforceCandidateStats {
+	std::string candidate;
+	idx_t probes = 0;
+	idx_t hits = 0;
+};
+
+// Observed hit rates of bruteforce candidates, shared by all queries of the process. With
+// sitemap_cache_dir set they are loaded from and saved to bruteforce_stats.tsv in that directory,
+// so the ranking keeps learning across sessions. I/O errors only cost the persisted counts.
+class BruteforceStats {
+public:
+	static constexpr const char *FILE_NAME = "bruteforce_stats.tsv";
+
+	static BruteforceStats &GetInstance();
+
+	void Record(const std::string &candidate, bool hit);
+	void Get(const std::string &candidate, idx_t &probes, idx_t &hits);
+	// Candidates that have been probed at least once
+	std::vector<BruteforceCandidateStats> GetStats();
+
+	// Merge the counts stored in directory, unless they were loaded from there already
+	void Load(FileSystem &fs, const std::string &directory);
+	// Write the counts to directory if anything was recorded since the last successful save
+	void Save(FileSystem &fs, const std::string &directory);
+
+private:
+	std::mutex mutex;
+	std::unordered_map<std::string, BruteforceCandidateStats> stats;
+	std::string loaded_directory;
+	// Bumped by every Record; the counts are dirty while saved_version lags behind
+	idx_t version = 0;
+	idx_t saved_version = 0;
+};
+
+// Probe order for bruteforce_find_sitemap(). Candidates are ranked by their smoothed observed hit
+// rate, with the built-in order as the prior: untried candidates keep their place and a candidate
+// only moves once there is data for it. Directories holding at least MIN_PRUNABLE_CANDIDATES
+// candidates are prunable - probes of the directory decide whether its generated candidates are
+// skipped. Common candidates are always probed.
+class BruteforcePlan {
+public:
+	static constexpr idx_t MIN_PRUNABLE_CANDIDATES = 6;
+	// Weight of the prior, in probes
+	static constexpr double PRIOR_WEIGHT = 10;
+	// Prior hit rate of the first built-in candidate; later ones get PRIOR_HIT_RATE / (1 + position)
+	static constexpr double PRIOR_HIT_RATE = 0.1;
+
+	// common_candidates are the well-known paths worth probing even on a catch-all site
+	BruteforcePlan(const std::vector<std::string> &candidates, const std::vector<std::string> &common_candidates,
+	               BruteforceStats &stats);
+
+	const std::vector<std::string> &Candidates() const {
+		return candidates;
+	}
+
+	bool IsCommon(idx_t candidate_idx) const {
+		return common[candidate_idx];
+	}
+
+	// Prunable directories above a candidate, outermost first (e.g. "sites/", "sites/default/")
+	const std::vector<std::string> &Directories(idx_t candidate_idx) const {
+		return directories[candidate_idx];
+	}
+
+private:
+	std::vector<std::string> candidates;
+	std::vector<bool> common;
+	std::vector<std::vector<std::string>> directories;
+};
+
+// Directory existence on one site. Each directory is probed at most once; concurrent callers wait
+// for the probe in flight. A probe that throws counts as present.
+class DirectoryPruner {
+public:
+	// probe returns true if the site proved not to have the directory
+	bool IsAbsent(const std::string &directory, const std::function<bool()> &probe);
+
+private:
+	enum class State : uint8_t { PENDING, PRESENT, ABSENT };
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::unordered_map<std::string, State> states;
+};
+
+} // namespace duckdb
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/error_data.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace duckdb {
+
+// Runs fetch tasks on a bounded set of worker threads, so at most max_in_flight requests are
+// outstanding at any time. Tasks may submit follow-up tasks (e.g. child sitemaps of an index);
+// Wait() returns once the queue is drained and no task is running. Tasks are expected to report
+// their own errors; the first exception that escapes one is kept and rethrown by Wait() and
+// ThrowIfFailed(), so a bug in a task fails the query instead of hanging it.
+class FetchEngine {
+public:
+	explicit FetchEngine(idx_t max_in_flight);
+	~FetchEngine();
+
+	// Delete copy
+	FetchEngine(const FetchEngine &) = delete;
+	FetchEngine &operator=(const FetchEngine &) = delete;
+
+	void Submit(std::function<void()> task);
+	void Wait();
+	// Rethrows the first exception that escaped a task, if any
+	void ThrowIfFailed();
+
+	idx_t MaxInFlight() const {
+		return max_in_flight;
+	}
+
+private:
+	void WorkerLoop();
+
+	idx_t max_in_flight;
+	std::mutex mutex;
+	std::condition_variable task_cv;
+	std::condition_variable idle_cv;
+	std::deque<std::function<void()>> tasks;
+	idx_t running = 0;
+	bool shutdown = false;
+	ErrorData error;
+	std::vector<std::thread> workers;
+};
+
+// First-winner resolution for speculatively started attempts with a fixed precedence (index 0
+// first). Outcomes may be reported in any order; the result is decided once an attempt has succeeded
+// and every attempt before it has failed, so it matches running them one after another. Attempts
+// after the best success so far are cancelled and should skip or abort their work.
+class PriorityResolver {
+public:
+	explicit PriorityResolver(idx_t count);
+
+	// Records the outcome of an attempt. Returns true for exactly one call: the one that decides
+	// the result (a winner, or all attempts failed).
+	bool Report(idx_t idx, bool success);
+
+	bool IsCancelled(idx_t idx) const {
+		return idx > best_success.load();
+	}
+
+	// Winning attempt once decided, or DConstants::INVALID_INDEX if every attempt failed
+	idx_t Winner() const;
+
+private:
+	enum class Outcome : uint8_t { PENDING, SUCCESS, FAILURE };
+
+	mutable std::mutex mutex;
+	std::vector<Outcome> outcomes;
+	// Every outcome before this index is a failure
+	idx_t next_undecided = 0;
+	std::atomic<idx_t> best_success;
+	idx_t winner;
+	bool decided = false;
+};
+
+} // namespace duckdb
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+struct HostLimits {
+	idx_t max_concurrency = 4;      // Concurrent requests per host
+	double requests_per_second = 10; // Token refill rate per host, 0 = unlimited
+};
+
+struct HostStats {
+	std::string host;
+	idx_t in_flight = 0;
+	idx_t queued = 0;
+	idx_t requests = 0;
+	double crawl_delay = 0;
+};
+
+// Process-wide politeness scheduler. Every request takes a permit for its host first: at most
+// max_concurrency permits are out per host, and a token bucket limits the start rate to
+// requests_per_second, lowered further by a robots.txt Crawl-delay. Buckets are keyed by host, so
+// raising global concurrency spreads load across hosts instead of onto one. Hosts without requests
+// for IDLE_HOST_TIMEOUT are forgotten, together with their Crawl-delay and request count.
+class HostScheduler {
+public:
+	static constexpr std::chrono::minutes IDLE_HOST_TIMEOUT {10};
+
+	class Permit {
+	public:
+		Permit(HostScheduler &scheduler, std::string host);
+		~Permit();
+
+		// Delete copy
+		Permit(const Permit &) = delete;
+		Permit &operator=(const Permit &) = delete;
+
+	private:
+		HostScheduler &scheduler;
+		std::string host;
+	};
+
+	static HostScheduler &GetInstance();
+
+	// Blocks until a request to the host may start. Returns nullptr if is_cancelled fires first.
+	unique_ptr<Permit> Acquire(const std::string &host, const HostLimits &limits,
+	                           const std::function<bool()> &is_cancelled = nullptr);
+	void SetCrawlDelay(const std::string &host, double seconds);
+	std::vector<HostStats> GetStats();
+
+	static std::string ExtractHost(const std::string &url);
+
+private:
+	struct HostState {
+		idx_t in_flight = 0;
+		idx_t queued = 0;
+		idx_t requests = 0;
+		double tokens = 1;
+		double crawl_delay = 0;
+		std::chrono::steady_clock::time_point last_refill = std::chrono::steady_clock::now();
+		std::chrono::steady_clock::time_point last_used = std::chrono::steady_clock::now();
+		std::condition_variable cv;
+	};
+
+	// How often a cancellable waiter polls its hook, and how often idle hosts are swept
+	static constexpr std::chrono::milliseconds CANCEL_POLL_INTERVAL {50};
+	static constexpr std::chrono::minutes PRUNE_INTERVAL {1};
+
+	HostState &GetHostState(const std::string &host);
+	void Release(const std::string &host);
+	void PruneIdleHosts(std::chrono::steady_clock::time_point now);
+
+	std::mutex mutex;
+	std::unordered_map<std::string, unique_ptr<HostState>> hosts;
+	std::chrono::steady_clock::time_point last_prune = std::chrono::steady_clock::now();
+};
+
+} // namespace duckdb
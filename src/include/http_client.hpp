@@ -1,18 +1,45 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "host_scheduler.hpp"
+#include <functional>
 #include <string>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace duckdb {
 
+class FileSystem;
+
 struct HttpResponse {
 	int status_code = 0;
 	std::string body;
 	std::string content_type;
 	std::string retry_after;
+	std::string etag;
+	std::string last_modified;
+	int64_t content_length = -1; // Content-Length header, -1 if absent
 	std::string error;
 	bool success = false;
+	// The body was cut off at HttpRequestOptions::max_body_bytes
+	bool truncated = false;
+};
+
+// Extra request headers by name, e.g. conditional If-None-Match / If-Modified-Since
+using HttpHeaderMap = std::map<std::string, std::string>;
+
+enum class HttpMethod : uint8_t { GET, HEAD };
+
+struct HttpRequestOptions {
+	HttpMethod method = HttpMethod::GET;
+	HttpHeaderMap headers;
+	// Stop reading a GET body after this many bytes (0 = no limit). The native backend drops the
+	// connection instead of draining the rest.
+	idx_t max_body_bytes = 0;
 };
 
 struct RetryConfig {
@@ -20,15 +47,123 @@ struct RetryConfig {
 	int initial_backoff_ms = 100;
 	double backoff_multiplier = 2.0;
 	int max_backoff_ms = 30000;
+	// Polled before each attempt and backoff; a cancelled fetch gives up with "Request cancelled"
+	std::function<bool()> is_cancelled;
+};
+
+enum class HttpBackend : uint8_t {
+	NATIVE,      // DuckDB's HTTPUtil with pooled keep-alive connections
+	HTTP_REQUEST // SQL round trip through the http_request community extension
+};
+
+// Idle keep-alive connections keyed by scheme://host:port. Lives in the client context, so
+// child sitemaps of an index, discovery probes and bruteforce probes against the same host
+// reuse TCP/TLS connections across fetches and queries.
+class HttpConnectionPool : public ClientContextState {
+public:
+	static constexpr idx_t MAX_IDLE_CONNECTIONS_PER_HOST = 16;
+
+	static shared_ptr<HttpConnectionPool> Get(ClientContext &context);
+
+	// Returns an idle connection for the host, or nullptr if a new one has to be opened
+	unique_ptr<HTTPClient> Acquire(const std::string &proto_host_port);
+	void Release(const std::string &proto_host_port, unique_ptr<HTTPClient> client);
+
+private:
+	std::mutex mutex;
+	std::unordered_map<std::string, vector<unique_ptr<HTTPClient>>> idle_connections;
+};
+
+// Fetcher state shared by all requests of one sitemap_urls / bruteforce_find_sitemap execution.
+// The native backend checks connections out of the context's HttpConnectionPool. The http_request
+// backend gives each worker thread its own connection with http_request loaded and prepared
+// http_get statements, so a fetch only binds the URL and header values.
+class HttpSession {
+public:
+	HttpSession(ClientContext &context, std::string user_agent);
+
+	// Delete copy
+	HttpSession(const HttpSession &) = delete;
+	HttpSession &operator=(const HttpSession &) = delete;
+
+	HttpResponse Request(const std::string &url, const HttpRequestOptions &options = HttpRequestOptions());
+
+	// file:// URLs are read from the local file system (sitemaps saved to disk, test fixtures)
+	static bool IsFileUrl(const std::string &url);
+
+	// Throws a MissingExtensionException if the session cannot fetch url: on the native backend, HTTPS
+	// needs httpfs. Called for the URLs a query starts from; later URLs get the same message as a
+	// request error.
+	void CheckSupported(const std::string &url) const;
+
+	HttpBackend Backend() const {
+		return backend;
+	}
+
+	const std::string &UserAgent() const {
+		return user_agent;
+	}
+
+	// Backend, user agent and connection settings (proxy, extra headers): requests from sessions with
+	// the same identity get interchangeable responses
+	const std::string &Identity() const {
+		return identity;
+	}
+
+	// The part of Identity() that outlives the process - user agent, proxy and extra headers. Keys the
+	// on-disk response cache.
+	const std::string &CacheIdentity() const {
+		return cache_identity;
+	}
+
+	const HostLimits &Limits() const {
+		return host_limits;
+	}
+
+	// Overrides the sitemap_max_host_* limits for this session
+	void SetLimits(const HostLimits &limits) {
+		host_limits = limits;
+	}
+
+private:
+	struct ThreadConnection {
+		unique_ptr<Connection> conn;
+		// http_get / http_head statements keyed by method and the names of the extra headers they bind
+		std::unordered_map<std::string, unique_ptr<PreparedStatement>> statements;
+		std::string error;
+	};
+
+	HttpResponse FileRequest(const std::string &url, const HttpRequestOptions &options);
+	HttpResponse NativeRequest(const std::string &url, const HttpRequestOptions &options);
+	HttpResponse HttpRequestQuery(const std::string &url, const HttpRequestOptions &options);
+	ThreadConnection &GetThreadConnection();
+	PreparedStatement &GetStatement(ThreadConnection &thread_conn, const HttpRequestOptions &options);
+
+	DatabaseInstance &db;
+	FileSystem &fs;
+	std::string user_agent;
+	std::string identity;
+	std::string cache_identity;
+	HttpBackend backend = HttpBackend::NATIVE;
+	HostLimits host_limits;
+
+	// Native backend
+	unique_ptr<HTTPParams> http_params;
+	// Whether httpfs is loaded; checked once, when the session starts
+	bool https_supported = false;
+	shared_ptr<HttpConnectionPool> pool;
+
+	// http_request backend
+	std::mutex connections_mutex;
+	std::unordered_map<std::thread::id, unique_ptr<ThreadConnection>> connections;
 };
 
 class HttpClient {
 public:
-	static HttpResponse Fetch(ClientContext &context, const std::string &url, const RetryConfig &config,
-	                          const std::string &user_agent = "");
+	static HttpResponse Fetch(HttpSession &session, const std::string &url, const RetryConfig &config,
+	                          const HttpRequestOptions &options = HttpRequestOptions());
 
 private:
-	static HttpResponse ExecuteHttpGet(DatabaseInstance &db, const std::string &url, const std::string &user_agent);
 	static bool IsRetryable(int status_code);
 	static int ParseRetryAfter(const std::string &retry_after);
 };
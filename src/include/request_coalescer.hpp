@@ -0,0 +1,52 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "http_client.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+// Process-wide singleflight table for HTTP request attempts. The first caller for a key makes the
+// request; callers that arrive while it is in flight wait for its response instead of issuing their
+// own, so overlapping queries and threads download a robots.txt or sitemap once. Only single attempts
+// are shared - retries and backoff stay with each caller. If the leader gives up before sending its
+// request (cancelled while waiting for a host permit), a waiter takes over as leader.
+class RequestCoalescer {
+public:
+	static RequestCoalescer &GetInstance();
+
+	// Identifies requests whose responses are interchangeable. session_identity is HttpSession::Identity().
+	static std::string MakeKey(const std::string &url, const std::string &session_identity,
+	                           const HttpRequestOptions &options);
+
+	// Runs attempt, or waits for the in-flight attempt of the same key. attempt returns false if it
+	// gave up without a response. Returns false if this caller got no response: its own attempt gave
+	// up, or is_cancelled fired while it was waiting.
+	bool Run(const std::string &key, const std::function<bool()> &is_cancelled, HttpResponse &response,
+	         const std::function<bool(HttpResponse &)> &attempt);
+
+private:
+	// How often a waiter polls its cancellation hook
+	static constexpr std::chrono::milliseconds CANCEL_POLL_INTERVAL {50};
+
+	struct Call {
+		bool done = false;
+		// The leader got a response, which is valid for its waiters
+		bool shared = false;
+		HttpResponse response;
+		// Waiters of this key only
+		std::condition_variable cv;
+	};
+
+	void Finish(const std::string &key, Call &call, const HttpResponse *response);
+
+	std::mutex mutex;
+	std::unordered_map<std::string, shared_ptr<Call>> calls;
+};
+
+} // namespace duckdb
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "http_client.hpp"
+#include <string>
+
+namespace duckdb {
+
+class FileSystem;
+
+// On-disk cache of sitemap responses in the directory set by sitemap_cache_dir. Each URL maps to one
+// file per user agent and header set, with its ETag / Last-Modified validators and the gzip-compressed
+// body. Later fetches send If-None-Match / If-Modified-Since, and a 304 is answered with the stored
+// body, so an unchanged sitemap costs a header-only round trip. Cache I/O errors never fail a fetch.
+class ResponseCache {
+public:
+	ResponseCache(FileSystem &fs, std::string directory);
+
+	// nullptr unless sitemap_cache_dir is set
+	static unique_ptr<ResponseCache> TryCreate(ClientContext &context);
+
+	// HttpClient::Fetch with revalidation against the cached copy. Bodies served from the cache stay
+	// gzip-compressed; the sitemap parser inflates them on the fly.
+	HttpResponse Fetch(HttpSession &session, const std::string &url, const RetryConfig &config);
+
+private:
+	struct Entry {
+		std::string etag;
+		std::string last_modified;
+		std::string content_type;
+		std::string body; // gzip
+	};
+
+	// Hash of the session's CacheIdentity(); entries are keyed by identity and URL
+	static std::string GetIdentity(const HttpSession &session);
+	std::string GetPath(const std::string &url, const std::string &identity) const;
+	bool Load(const std::string &url, const std::string &identity, Entry &entry);
+	void Store(const std::string &url, const std::string &identity, const HttpResponse &response);
+
+	FileSystem &fs;
+	std::string directory;
+};
+
+} // namespace duckdb
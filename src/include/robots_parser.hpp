@@ -7,7 +7,13 @@ namespace duckdb {
 
 class RobotsParser {
 public:
+	// Longer Crawl-delays are lowered to this, so a robots.txt cannot stall a scan indefinitely
+	static constexpr double MAX_CRAWL_DELAY = 60;
+
 	static std::vector<std::string> ParseSitemapUrls(const std::string &robots_txt_content);
+	// Crawl-delay in seconds for the group matching user_agent, falling back to "*"; 0 if none. Values
+	// are clamped to [0, MAX_CRAWL_DELAY]; NaN is ignored.
+	static double ParseCrawlDelay(const std::string &robots_txt_content, const std::string &user_agent);
 };
 
 } // namespace duckdb
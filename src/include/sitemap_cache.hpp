@@ -0,0 +1,84 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+struct SitemapCacheStats {
+	idx_t entries = 0;
+	idx_t negative_entries = 0;
+	idx_t memory_bytes = 0;
+	idx_t memory_limit = 0;
+	idx_t hits = 0;
+	idx_t negative_hits = 0;
+	idx_t misses = 0;
+	idx_t evictions = 0;
+	idx_t expirations = 0;
+};
+
+// Process-wide cache of discovery results (base URL and mode -> sitemap URLs and the robots.txt
+// Crawl-delay, which a cache hit has to reapply because it skips robots.txt). Every entry has its own
+// expiry, and failed discoveries are cached as negative entries with a shorter TTL, so a domain
+// without a sitemap is not probed again on every query. Keys are spread over shards with their own
+// mutex and LRU list; a shard evicts its least recently used entries once it exceeds its share of
+// the memory budget.
+class SitemapCache {
+public:
+	static constexpr idx_t SHARD_COUNT = 16;
+	static constexpr idx_t DEFAULT_MEMORY_LIMIT = 32 * 1024 * 1024;
+
+	enum class LookupResult : uint8_t { MISS, HIT, NEGATIVE_HIT };
+
+	static SitemapCache &GetInstance();
+
+	explicit SitemapCache(idx_t memory_limit = DEFAULT_MEMORY_LIMIT);
+
+	LookupResult Get(const std::string &base_url, std::vector<std::string> &sitemaps, double &crawl_delay);
+	// An empty list caches a failed discovery
+	void Set(const std::string &base_url, std::vector<std::string> sitemaps, std::chrono::seconds ttl,
+	         double crawl_delay = 0);
+
+	SitemapCacheStats GetStats();
+	// Drops every entry; returns how many there were
+	idx_t Clear();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Entry {
+		std::string base_url;
+		std::vector<std::string> sitemaps;
+		double crawl_delay = 0;
+		Clock::time_point expires_at;
+		idx_t memory_bytes = 0;
+	};
+
+	struct Shard {
+		std::mutex mutex;
+		std::list<Entry> lru; // Most recently used first
+		std::unordered_map<std::string, std::list<Entry>::iterator> index;
+		idx_t memory_bytes = 0;
+	};
+
+	Shard &GetShard(const std::string &base_url);
+	static idx_t EstimateMemory(const Entry &entry);
+	void Erase(Shard &shard, std::list<Entry>::iterator it);
+
+	idx_t shard_memory_limit;
+	Shard shards[SHARD_COUNT];
+
+	std::atomic<idx_t> hits {0};
+	std::atomic<idx_t> negative_hits {0};
+	std::atomic<idx_t> misses {0};
+	std::atomic<idx_t> evictions {0};
+	std::atomic<idx_t> expirations {0};
+};
+
+} // namespace duckdb
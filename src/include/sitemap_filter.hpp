@@ -0,0 +1,82 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/table_filter.hpp"
+#include "xml_parser.hpp"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace duckdb {
+
+// Output columns of sitemap_urls(), in bind order
+static constexpr column_t SITEMAP_COLUMN_URL = 0;
+static constexpr column_t SITEMAP_COLUMN_LASTMOD = 1;
+static constexpr column_t SITEMAP_COLUMN_CHANGEFREQ = 2;
+static constexpr column_t SITEMAP_COLUMN_PRIORITY = 3;
+static constexpr column_t SITEMAP_COLUMN_COUNT = 4;
+
+static std::string SitemapEntry::*const SITEMAP_COLUMN_FIELDS[SITEMAP_COLUMN_COUNT] = {
+    &SitemapEntry::url, &SitemapEntry::lastmod, &SitemapEntry::changefreq, &SitemapEntry::priority};
+
+// Table filters pushed into sitemap_urls(). Comparisons, IN lists, NULL checks and contains /
+// prefix / suffix with a constant (what LIKE '%x%', 'x%' and '%x' are rewritten to) on the VARCHAR
+// columns, and AND/OR trees of them, are evaluated on the parsed strings before an entry is
+// buffered. Anything else becomes one residual expression that SitemapResidualFilter evaluates
+// vectorized over the buffered entries. Empty fields are NULL.
+class SitemapEntryFilter {
+public:
+	SitemapEntryFilter() = default;
+	SitemapEntryFilter(const TableFilterSet &filters, const vector<column_t> &column_ids);
+
+	bool Matches(const SitemapEntry &entry) const;
+
+	// Largest constant C such that every matching entry has field >= C (from =, > and >= predicates)
+	bool TryGetLowerBound(std::string SitemapEntry::*field, std::string &bound) const;
+
+	// AND of the filters that could not be evaluated on strings, over a chunk with one VARCHAR column
+	// per sitemap column; nullptr if there are none
+	const Expression *Residual() const {
+		return residual.get();
+	}
+
+private:
+	struct Predicate {
+		enum class Kind : uint8_t { COMPARE, IN, IS_NULL, IS_NOT_NULL, CONTAINS, PREFIX, SUFFIX, AND, OR };
+
+		Kind kind = Kind::AND;
+		std::string SitemapEntry::*field = nullptr;
+		ExpressionType comparison = ExpressionType::COMPARE_EQUAL;
+		std::string constant;
+		std::unordered_set<std::string> values;
+		std::vector<Predicate> children;
+	};
+
+	static bool TryConvert(const TableFilter &filter, std::string SitemapEntry::*field, Predicate &result);
+	static bool TryConvertExpression(const Expression &expression, Predicate &result);
+	static bool TryConvertChildren(const vector<unique_ptr<TableFilter>> &child_filters,
+	                               std::string SitemapEntry::*field, Predicate &result);
+	static bool Evaluate(const Predicate &predicate, const SitemapEntry &entry);
+	static void CollectLowerBound(const Predicate &predicate, std::string SitemapEntry::*field, bool &found,
+	                              std::string &bound);
+
+	std::vector<Predicate> predicates;
+	unique_ptr<Expression> residual;
+};
+
+// Per-thread evaluator of SitemapEntryFilter::Residual()
+class SitemapResidualFilter {
+public:
+	SitemapResidualFilter(ClientContext &context, const Expression &expression);
+
+	// Drops the entries from start onwards that do not pass
+	void Apply(std::vector<SitemapEntry> &entries, idx_t start);
+
+private:
+	ExpressionExecutor executor;
+	DataChunk chunk;
+	SelectionVector sel;
+};
+
+} // namespace duckdb
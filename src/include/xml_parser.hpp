@@ -1,10 +1,10 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <libxml/parser.h>
-#include <libxml/xpath.h>
-#include <libxml/xpathInternals.h>
+#include <zlib.h>
 
 namespace duckdb {
 
@@ -15,26 +15,86 @@ struct SitemapEntry {
 	std::string priority;
 };
 
+// <sitemap> entry of a sitemap index
+struct SitemapIndexEntry {
+	std::string loc;
+	std::string lastmod; // Last change of the child sitemap, empty if not given
+};
+
+// Optional <url> child elements to extract. <loc> is always read; unselected elements are skipped
+// without copying their text.
+struct SitemapFields {
+	bool lastmod = true;
+	bool changefreq = true;
+	bool priority = true;
+};
+
 enum class SitemapType {
 	URLSET,      // Regular sitemap with <url> entries
 	SITEMAPINDEX // Index pointing to other sitemaps
 };
 
+// What the first bytes of a response look like, see XmlParser::SniffSitemap
+enum class SitemapSniff : uint8_t {
+	NONE,
+	URLSET,       // <urlset> document
+	SITEMAPINDEX, // <sitemapindex> document
+	URL_LIST      // Plain text sitemap, one absolute URL per line
+};
+
 struct SitemapParseResult {
 	SitemapType type;
 	std::vector<SitemapEntry> urls;      // For URLSET
-	std::vector<std::string> sitemaps;   // For SITEMAPINDEX
+	std::vector<SitemapIndexEntry> sitemaps; // For SITEMAPINDEX
 	std::string error;
 	bool success = false;
 };
 
+// Incremental gunzip over an in-memory body. Each Read() inflates at most one BUFFER_SIZE chunk,
+// so the decompressed document never exists in one piece and can be handed straight to a push
+// parser. Input without the gzip magic bytes is passed through in chunks of the same size.
+class GzipStreamReader {
+public:
+	static constexpr size_t BUFFER_SIZE = 32768;
+
+	// The input must outlive the reader
+	explicit GzipStreamReader(const std::string &input);
+	~GzipStreamReader();
+
+	// Delete copy
+	GzipStreamReader(const GzipStreamReader &) = delete;
+	GzipStreamReader &operator=(const GzipStreamReader &) = delete;
+
+	// Points data at the next chunk. Returns false at the end of the input or on a decompression
+	// error, in which case Error() is set. The chunk stays valid until the next call.
+	bool Read(const char *&data, size_t &size);
+
+	bool IsGzipped() const {
+		return gzipped;
+	}
+	const std::string &Error() const {
+		return error;
+	}
+
+private:
+	const std::string &input;
+	size_t input_offset = 0;
+	bool gzipped = false;
+	bool stream_initialized = false;
+	bool finished = false;
+	z_stream zs;
+	char buffer[BUFFER_SIZE];
+	std::string error;
+};
+
 // RAII wrapper for libxml2 document
 class XMLDocRAII {
 public:
 	xmlDocPtr doc = nullptr;
-	xmlXPathContextPtr xpath_ctx = nullptr;
 
 	explicit XMLDocRAII(const std::string &content);
+	// Builds the document with a push parser, one reader chunk at a time
+	explicit XMLDocRAII(GzipStreamReader &reader);
 	~XMLDocRAII();
 
 	// Delete copy
@@ -50,15 +110,78 @@ public:
 	}
 };
 
+// Incremental sitemap parser on libxml2's SAX2 push interface. Feed() takes the document in
+// arbitrary chunks and entries are handed to the callbacks as each </url> or </sitemap> closes,
+// so no tree is built and parser memory stays O(one entry) regardless of document size.
+class SitemapStreamParser {
+public:
+	using EntryCallback = std::function<void(SitemapEntry &entry)>;
+	using SitemapCallback = std::function<void(SitemapIndexEntry &sitemap)>;
+
+	SitemapStreamParser(EntryCallback on_entry, SitemapCallback on_sitemap, SitemapFields fields = SitemapFields());
+	~SitemapStreamParser();
+
+	// Delete copy
+	SitemapStreamParser(const SitemapStreamParser &) = delete;
+	SitemapStreamParser &operator=(const SitemapStreamParser &) = delete;
+
+	// Both return false once the document is known to be invalid; see Error()
+	bool Feed(const char *data, size_t size);
+	bool Finish();
+
+	bool HasRoot() const {
+		return has_root;
+	}
+	SitemapType Type() const {
+		return type;
+	}
+	const std::string &Error() const {
+		return error;
+	}
+
+private:
+	enum class Field { NONE, LOC, LASTMOD, CHANGEFREQ, PRIORITY };
+
+	static void OnStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri,
+	                           int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted,
+	                           const xmlChar **attributes);
+	static void OnEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri);
+	static void OnCharacters(void *ctx, const xmlChar *ch, int len);
+
+	bool CheckParseResult(int ret);
+	std::string *CurrentText();
+
+	xmlParserCtxtPtr ctxt = nullptr;
+	EntryCallback on_entry;
+	SitemapCallback on_sitemap;
+	SitemapFields fields;
+
+	bool has_root = false;
+	SitemapType type = SitemapType::URLSET;
+	std::string error;
+
+	int depth = 0;
+	bool in_item = false; // Inside <url> or <sitemap>
+	Field field = Field::NONE;
+	SitemapEntry current;
+};
+
 class XmlParser {
 public:
 	static void Initialize();
 	static void Cleanup();
 
-	static SitemapParseResult ParseSitemap(const std::string &xml_content);
+	static SitemapParseResult ParseSitemap(const std::string &xml_content, SitemapFields fields = SitemapFields());
+	// Same as above for a (possibly gzipped) body that is decompressed while the tree is built
+	static SitemapParseResult ParseSitemap(GzipStreamReader &reader, SitemapFields fields = SitemapFields());
+	// Same result as ParseSitemap, built with SitemapStreamParser instead of a DOM
+	static SitemapParseResult ParseSitemapStreaming(const std::string &xml_content);
 	static std::string DecompressGzip(const std::string &compressed);
-	static bool IsGzipped(const std::string &url, const std::string &content_type);
+	static std::string CompressGzip(const std::string &data);
 	static std::vector<std::string> FindSitemapInHtml(const std::string &html_content);
+	// Classify a response from its first bytes (a gzip prefix is inflated first). Works on
+	// truncated bodies, so a probe only needs to download a few KB.
+	static SitemapSniff SniffSitemap(const std::string &prefix);
 };
 
 } // namespace duckdb
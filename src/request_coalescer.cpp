@@ -0,0 +1,74 @@
+#include "request_coalescer.hpp"
+
+namespace duckdb {
+
+constexpr std::chrono::milliseconds RequestCoalescer::CANCEL_POLL_INTERVAL;
+
+RequestCoalescer &RequestCoalescer::GetInstance() {
+	static RequestCoalescer instance;
+	return instance;
+}
+
+std::string RequestCoalescer::MakeKey(const std::string &url, const std::string &session_identity,
+                                      const HttpRequestOptions &options) {
+	// Fields are separated by newlines, which cannot occur in a URL or header
+	std::string key = options.method == HttpMethod::HEAD ? "HEAD\n" : "GET\n";
+	key += url + "\n" + std::to_string(options.max_body_bytes) + "\n";
+	for (auto &header : options.headers) {
+		key += header.first + ": " + header.second + "\n";
+	}
+	return key + session_identity;
+}
+
+bool RequestCoalescer::Run(const std::string &key, const std::function<bool()> &is_cancelled,
+                           HttpResponse &response, const std::function<bool(HttpResponse &)> &attempt) {
+	shared_ptr<Call> call;
+	while (true) {
+		std::unique_lock<std::mutex> lock(mutex);
+		auto it = calls.find(key);
+		if (it == calls.end()) {
+			call = make_shared_ptr<Call>();
+			calls[key] = call;
+			break;
+		}
+
+		auto in_flight = it->second;
+		while (!in_flight->done) {
+			if (!is_cancelled) {
+				in_flight->cv.wait(lock);
+			} else if (is_cancelled()) {
+				return false;
+			} else {
+				in_flight->cv.wait_for(lock, CANCEL_POLL_INTERVAL);
+			}
+		}
+		if (in_flight->shared) {
+			response = in_flight->response;
+			return true;
+		}
+		// The leader gave up without a response - look again, the next caller in becomes the leader
+	}
+
+	bool attempted;
+	try {
+		attempted = attempt(response);
+	} catch (...) {
+		Finish(key, *call, nullptr);
+		throw;
+	}
+	Finish(key, *call, attempted ? &response : nullptr);
+	return attempted;
+}
+
+void RequestCoalescer::Finish(const std::string &key, Call &call, const HttpResponse *response) {
+	std::lock_guard<std::mutex> lock(mutex);
+	call.done = true;
+	if (response) {
+		call.response = *response;
+		call.shared = true;
+	}
+	calls.erase(key);
+	call.cv.notify_all();
+}
+
+} // namespace duckdb
@@ -0,0 +1,156 @@
+#include "response_cache.hpp"
+#include "xml_parser.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+namespace duckdb {
+
+// File layout: a version line, one line each for url, identity, etag, last_modified and content_type,
+// then the gzip body. The identity is a hash of HttpSession::CacheIdentity(), so credentials in extra
+// headers never reach the disk. Header values cannot contain line breaks, so no escaping is needed.
+static const char *CACHE_FILE_MAGIC = "duckdb-sitemap-cache-v2";
+static constexpr idx_t CACHE_HEADER_LINES = 6;
+
+ResponseCache::ResponseCache(FileSystem &fs_p, std::string directory_p) : fs(fs_p), directory(std::move(directory_p)) {
+}
+
+unique_ptr<ResponseCache> ResponseCache::TryCreate(ClientContext &context) {
+	Value dir_value;
+	if (!context.TryGetCurrentSetting("sitemap_cache_dir", dir_value) || dir_value.IsNull()) {
+		return nullptr;
+	}
+	auto directory = dir_value.GetValue<std::string>();
+	if (directory.empty()) {
+		return nullptr;
+	}
+	return make_uniq<ResponseCache>(FileSystem::GetFileSystem(context), std::move(directory));
+}
+
+static std::string HexHash(hash_t hash) {
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+	return hex;
+}
+
+std::string ResponseCache::GetIdentity(const HttpSession &session) {
+	auto &identity = session.CacheIdentity();
+	return HexHash(Hash(identity.c_str(), identity.size()));
+}
+
+std::string ResponseCache::GetPath(const std::string &url, const std::string &identity) const {
+	auto key = identity + "\n" + url;
+	return fs.JoinPath(directory, HexHash(Hash(key.c_str(), key.size())) + ".cache");
+}
+
+bool ResponseCache::Load(const std::string &url, const std::string &identity, Entry &entry) {
+	std::string data;
+	try {
+		auto handle = fs.OpenFile(GetPath(url, identity),
+		                          FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (!handle) {
+			return false;
+		}
+		data.resize(static_cast<size_t>(handle->GetFileSize()));
+		handle->Read(&data[0], data.size());
+	} catch (std::exception &) {
+		return false;
+	}
+
+	std::string lines[CACHE_HEADER_LINES];
+	size_t offset = 0;
+	for (idx_t i = 0; i < CACHE_HEADER_LINES; i++) {
+		auto end = data.find('\n', offset);
+		if (end == std::string::npos) {
+			return false;
+		}
+		lines[i] = data.substr(offset, end - offset);
+		offset = end + 1;
+	}
+	// Different format version or a hash collision
+	if (lines[0] != CACHE_FILE_MAGIC || lines[1] != url || lines[2] != identity) {
+		return false;
+	}
+	entry.etag = std::move(lines[3]);
+	entry.last_modified = std::move(lines[4]);
+	entry.content_type = std::move(lines[5]);
+	entry.body = data.substr(offset);
+	return true;
+}
+
+void ResponseCache::Store(const std::string &url, const std::string &identity, const HttpResponse &response) {
+	// Already gzipped bodies (.xml.gz) are stored as they are
+	auto body = response.body;
+	if (body.size() < 2 || static_cast<unsigned char>(body[0]) != 0x1f || static_cast<unsigned char>(body[1]) != 0x8b) {
+		body = XmlParser::CompressGzip(body);
+		if (body.empty()) {
+			return;
+		}
+	}
+
+	std::string data = std::string(CACHE_FILE_MAGIC) + "\n" + url + "\n" + identity + "\n" + response.etag + "\n" +
+	                   response.last_modified + "\n" + response.content_type + "\n";
+	data += body;
+
+	// Write to a temporary file and rename, so readers never see a partial entry
+	auto path = GetPath(url, identity);
+	auto temp_path = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	try {
+		if (!fs.DirectoryExists(directory)) {
+			fs.CreateDirectory(directory);
+		}
+		{
+			auto handle = fs.OpenFile(temp_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			handle->Write(&data[0], data.size());
+			handle->Close();
+		}
+		fs.MoveFile(temp_path, path);
+	} catch (std::exception &) {
+		try {
+			fs.TryRemoveFile(temp_path);
+		} catch (std::exception &) {
+		}
+	}
+}
+
+HttpResponse ResponseCache::Fetch(HttpSession &session, const std::string &url, const RetryConfig &config) {
+	// Responses fetched with another user agent or other extra headers may differ
+	auto identity = GetIdentity(session);
+	Entry entry;
+	bool cached = Load(url, identity, entry);
+
+	HttpRequestOptions options;
+	if (cached && !entry.etag.empty()) {
+		options.headers["If-None-Match"] = entry.etag;
+	}
+	if (cached && !entry.last_modified.empty()) {
+		options.headers["If-Modified-Since"] = entry.last_modified;
+	}
+
+	auto response = HttpClient::Fetch(session, url, config, options);
+	if (response.status_code == 304 && cached) {
+		// Not modified - serve the stored copy
+		response.success = true;
+		response.error.clear();
+		response.body = std::move(entry.body);
+		response.content_type = std::move(entry.content_type);
+		if (response.etag.empty()) {
+			response.etag = std::move(entry.etag);
+		}
+		if (response.last_modified.empty()) {
+			response.last_modified = std::move(entry.last_modified);
+		}
+		return response;
+	}
+
+	// Without a validator the copy could never be revalidated
+	if (response.success && (!response.etag.empty() || !response.last_modified.empty())) {
+		Store(url, identity, response);
+	}
+	return response;
+}
+
+} // namespace duckdb
@@ -2,9 +2,12 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 
 namespace duckdb {
 
+constexpr double RobotsParser::MAX_CRAWL_DELAY;
+
 // Trim whitespace from both ends of a string
 static std::string Trim(const std::string &str) {
 	size_t start = 0;
@@ -69,4 +72,83 @@ std::vector<std::string> RobotsParser::ParseSitemapUrls(const std::string &robot
 	return sitemaps;
 }
 
+// Lowercased product token of a User-Agent string ("MyBot/1.0 (+url)" -> "mybot")
+static std::string ProductToken(const std::string &user_agent) {
+	std::string token;
+	for (char c : user_agent) {
+		if (c == '/' || std::isspace(static_cast<unsigned char>(c))) {
+			break;
+		}
+		token += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+	return token;
+}
+
+double RobotsParser::ParseCrawlDelay(const std::string &robots_txt_content, const std::string &user_agent) {
+	std::istringstream stream(robots_txt_content);
+	std::string line;
+
+	const std::string user_agent_prefix = "user-agent:";
+	const std::string crawl_delay_prefix = "crawl-delay:";
+	const std::string product = ProductToken(user_agent);
+
+	double wildcard_delay = 0;
+	double specific_delay = 0;
+	bool has_specific_delay = false;
+	bool group_is_wildcard = false;
+	bool group_is_specific = false;
+	bool in_agent_lines = false;
+
+	while (std::getline(stream, line)) {
+		// Strip comments and trim the line
+		auto comment = line.find('#');
+		if (comment != std::string::npos) {
+			line = line.substr(0, comment);
+		}
+		line = Trim(line);
+		if (line.empty()) {
+			continue;
+		}
+
+		if (StartsWithCaseInsensitive(line, user_agent_prefix)) {
+			// Consecutive User-agent lines share one group
+			if (!in_agent_lines) {
+				group_is_wildcard = false;
+				group_is_specific = false;
+				in_agent_lines = true;
+			}
+			std::string agent = ProductToken(Trim(line.substr(user_agent_prefix.length())));
+			if (agent == "*") {
+				group_is_wildcard = true;
+			} else if (!agent.empty() && agent == product) {
+				group_is_specific = true;
+			}
+			continue;
+		}
+		in_agent_lines = false;
+
+		if (StartsWithCaseInsensitive(line, crawl_delay_prefix)) {
+			double delay = 0;
+			try {
+				delay = std::stod(Trim(line.substr(crawl_delay_prefix.length())));
+			} catch (...) {
+				continue;
+			}
+			if (std::isnan(delay)) {
+				continue;
+			}
+			// Also turns "inf" into the longest delay instead of a zero rate, i.e. no limit
+			delay = std::min(std::max(delay, 0.0), MAX_CRAWL_DELAY);
+			if (group_is_specific) {
+				specific_delay = delay;
+				has_specific_delay = true;
+			} else if (group_is_wildcard) {
+				wildcard_delay = delay;
+			}
+		}
+	}
+
+	return has_specific_delay ? specific_delay : wildcard_delay;
+}
+
 } // namespace duckdb
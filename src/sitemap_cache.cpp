@@ -0,0 +1,136 @@
+#include "sitemap_cache.hpp"
+#include <functional>
+
+namespace duckdb {
+
+SitemapCache &SitemapCache::GetInstance() {
+	static SitemapCache instance;
+	return instance;
+}
+
+SitemapCache::SitemapCache(idx_t memory_limit) : shard_memory_limit(MaxValue<idx_t>(1, memory_limit / SHARD_COUNT)) {
+}
+
+SitemapCache::Shard &SitemapCache::GetShard(const std::string &base_url) {
+	return shards[std::hash<std::string> {}(base_url) % SHARD_COUNT];
+}
+
+idx_t SitemapCache::EstimateMemory(const Entry &entry) {
+	// Strings plus list node, index slot and per-string bookkeeping
+	static constexpr idx_t ENTRY_OVERHEAD = 128;
+	static constexpr idx_t STRING_OVERHEAD = 32;
+	idx_t bytes = ENTRY_OVERHEAD + 2 * (entry.base_url.size() + STRING_OVERHEAD);
+	for (auto &sitemap : entry.sitemaps) {
+		bytes += sitemap.size() + STRING_OVERHEAD;
+	}
+	return bytes;
+}
+
+void SitemapCache::Erase(Shard &shard, std::list<Entry>::iterator it) {
+	shard.memory_bytes -= it->memory_bytes;
+	shard.index.erase(it->base_url);
+	shard.lru.erase(it);
+}
+
+SitemapCache::LookupResult SitemapCache::Get(const std::string &base_url, std::vector<std::string> &sitemaps,
+                                             double &crawl_delay) {
+	auto &shard = GetShard(base_url);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	auto found = shard.index.find(base_url);
+	if (found == shard.index.end()) {
+		misses++;
+		return LookupResult::MISS;
+	}
+	auto it = found->second;
+	if (Clock::now() >= it->expires_at) {
+		Erase(shard, it);
+		expirations++;
+		misses++;
+		return LookupResult::MISS;
+	}
+
+	// Move to the front of the LRU list
+	shard.lru.splice(shard.lru.begin(), shard.lru, it);
+	if (it->sitemaps.empty()) {
+		negative_hits++;
+		return LookupResult::NEGATIVE_HIT;
+	}
+	hits++;
+	sitemaps = it->sitemaps;
+	crawl_delay = it->crawl_delay;
+	return LookupResult::HIT;
+}
+
+void SitemapCache::Set(const std::string &base_url, std::vector<std::string> sitemaps, std::chrono::seconds ttl,
+                       double crawl_delay) {
+	if (ttl.count() <= 0) {
+		return;
+	}
+
+	Entry entry;
+	entry.base_url = base_url;
+	entry.sitemaps = std::move(sitemaps);
+	entry.crawl_delay = crawl_delay;
+	entry.expires_at = Clock::now() + ttl;
+	entry.memory_bytes = EstimateMemory(entry);
+	if (entry.memory_bytes > shard_memory_limit) {
+		return; // Would evict the whole shard
+	}
+
+	auto &shard = GetShard(base_url);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	auto found = shard.index.find(base_url);
+	if (found != shard.index.end()) {
+		Erase(shard, found->second);
+	}
+	shard.memory_bytes += entry.memory_bytes;
+	shard.lru.push_front(std::move(entry));
+	shard.index[base_url] = shard.lru.begin();
+
+	// Evict from the tail until the shard is back within its budget
+	while (shard.memory_bytes > shard_memory_limit && shard.lru.size() > 1) {
+		Erase(shard, std::prev(shard.lru.end()));
+		evictions++;
+	}
+}
+
+SitemapCacheStats SitemapCache::GetStats() {
+	SitemapCacheStats stats;
+	auto now = Clock::now();
+	for (auto &shard : shards) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for (auto &entry : shard.lru) {
+			if (now >= entry.expires_at) {
+				continue;
+			}
+			stats.entries++;
+			if (entry.sitemaps.empty()) {
+				stats.negative_entries++;
+			}
+		}
+		stats.memory_bytes += shard.memory_bytes;
+	}
+	stats.memory_limit = shard_memory_limit * SHARD_COUNT;
+	stats.hits = hits;
+	stats.negative_hits = negative_hits;
+	stats.misses = misses;
+	stats.evictions = evictions;
+	stats.expirations = expirations;
+	return stats;
+}
+
+idx_t SitemapCache::Clear() {
+	idx_t removed = 0;
+	for (auto &shard : shards) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		removed += shard.lru.size();
+		shard.lru.clear();
+		shard.index.clear();
+		shard.memory_bytes = 0;
+	}
+	return removed;
+}
+
+} // namespace duckdb
@@ -3,14 +3,65 @@
 #include "sitemap_extension.hpp"
 #include "sitemap_function.hpp"
 #include "bruteforce_function.hpp"
+#include "diagnostics_function.hpp"
 #include "xml_parser.hpp"
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
-#include "duckdb/main/connection.hpp"
 #include "duckdb/main/config.hpp"
+#include "duckdb/common/string_util.hpp"
 
 namespace duckdb {
 
+static void SetHttpBackend(ClientContext &context, SetScope scope, Value &parameter) {
+	auto backend = StringUtil::Lower(parameter.GetValue<std::string>());
+	if (backend != "native" && backend != "http_request") {
+		throw InvalidInputException("sitemap_http_backend must be 'native' or 'http_request', got '%s'", backend);
+	}
+}
+
+static void SetXmlParser(ClientContext &context, SetScope scope, Value &parameter) {
+	auto parser = StringUtil::Lower(parameter.GetValue<std::string>());
+	if (parser != "streaming" && parser != "dom") {
+		throw InvalidInputException("sitemap_xml_parser must be 'streaming' or 'dom', got '%s'", parser);
+	}
+}
+
+static void SetMaxConcurrency(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.GetValue<int64_t>() < 1) {
+		throw InvalidInputException("sitemap_max_concurrency must be at least 1");
+	}
+}
+
+static void SetMaxHostConcurrency(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.GetValue<int64_t>() < 1) {
+		throw InvalidInputException("sitemap_max_host_concurrency must be at least 1");
+	}
+}
+
+static void SetBruteforceConcurrency(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.GetValue<int64_t>() < 1) {
+		throw InvalidInputException("sitemap_bruteforce_concurrency must be at least 1");
+	}
+}
+
+static void SetCacheTtl(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.GetValue<int64_t>() < 0) {
+		throw InvalidInputException("sitemap cache TTL must not be negative");
+	}
+}
+
+static void SetMaxHostRps(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.GetValue<double>() < 0) {
+		throw InvalidInputException("sitemap_max_host_rps must not be negative");
+	}
+}
+
+static void SetBruteforceMaxHostRps(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.GetValue<double>() < 0) {
+		throw InvalidInputException("sitemap_bruteforce_max_host_rps must not be negative");
+	}
+}
+
 static void LoadInternal(ExtensionLoader &loader) {
 	auto &db = loader.GetDatabaseInstance();
 	auto &config = DBConfig::GetConfig(db);
@@ -21,20 +72,72 @@ static void LoadInternal(ExtensionLoader &loader) {
 	                          LogicalType::VARCHAR,
 	                          Value("DuckDB-Sitemap/1.0"));
 
-	Connection conn(db);
+	// Register sitemap_http_backend setting
+	config.AddExtensionOption("sitemap_http_backend",
+	                          "HTTP backend for sitemap requests: 'native' (pooled keep-alive connections) or "
+	                          "'http_request' (SQL round trip through the http_request extension, which is "
+	                          "installed on first use)",
+	                          LogicalType::VARCHAR,
+	                          Value("native"),
+	                          SetHttpBackend);
 
-	// Install and load http_request from community
-	auto install_result = conn.Query("INSTALL http_request FROM community");
-	if (install_result->HasError()) {
-		throw IOException("Sitemap extension requires http_request extension. Failed to install: " +
-		                  install_result->GetError());
-	}
+	// Register sitemap_xml_parser setting
+	config.AddExtensionOption("sitemap_xml_parser",
+	                          "Sitemap XML parser: 'streaming' (SAX2, constant memory) or 'dom' (whole libxml2 tree)",
+	                          LogicalType::VARCHAR,
+	                          Value("streaming"),
+	                          SetXmlParser);
+
+	// Register sitemap_max_concurrency setting
+	config.AddExtensionOption("sitemap_max_concurrency",
+	                          "Maximum number of sitemap HTTP requests in flight per sitemap_urls() call",
+	                          LogicalType::INTEGER,
+	                          Value::INTEGER(8),
+	                          SetMaxConcurrency);
+
+	// Register sitemap_bruteforce_concurrency setting
+	config.AddExtensionOption("sitemap_bruteforce_concurrency",
+	                          "Maximum number of bruteforce_find_sitemap() probes in flight per thread",
+	                          LogicalType::INTEGER,
+	                          Value::INTEGER(16),
+	                          SetBruteforceConcurrency);
+	config.AddExtensionOption("sitemap_bruteforce_max_host_rps",
+	                          "Maximum bruteforce probes per second per host (0 = unlimited); replaces "
+	                          "sitemap_max_host_rps for probes, a robots.txt Crawl-delay still applies",
+	                          LogicalType::DOUBLE,
+	                          Value::DOUBLE(100),
+	                          SetBruteforceMaxHostRps);
+
+	// Register per-host politeness settings
+	config.AddExtensionOption("sitemap_max_host_concurrency",
+	                          "Maximum number of concurrent sitemap HTTP requests per host",
+	                          LogicalType::INTEGER,
+	                          Value::INTEGER(4),
+	                          SetMaxHostConcurrency);
+	config.AddExtensionOption("sitemap_max_host_rps",
+	                          "Maximum sitemap HTTP requests per second per host (0 = unlimited); "
+	                          "a robots.txt Crawl-delay lowers it further",
+	                          LogicalType::DOUBLE,
+	                          Value::DOUBLE(10),
+	                          SetMaxHostRps);
+
+	config.AddExtensionOption("sitemap_cache_dir",
+	                          "Directory for the persistent sitemap response cache, revalidated with "
+	                          "ETag / Last-Modified (empty = disabled)",
+	                          LogicalType::VARCHAR,
+	                          Value(""));
 
-	auto load_result = conn.Query("LOAD http_request");
-	if (load_result->HasError()) {
-		throw IOException("Sitemap extension requires http_request extension. Failed to load: " +
-		                  load_result->GetError());
-	}
+	config.AddExtensionOption("sitemap_cache_ttl",
+	                          "Seconds a discovered sitemap list is reused for a base URL (0 = no caching)",
+	                          LogicalType::INTEGER,
+	                          Value::INTEGER(3600),
+	                          SetCacheTtl);
+
+	config.AddExtensionOption("sitemap_cache_negative_ttl",
+	                          "Seconds a failed sitemap discovery is remembered for a base URL (0 = no caching)",
+	                          LogicalType::INTEGER,
+	                          Value::INTEGER(300),
+	                          SetCacheTtl);
 
 	// Initialize libxml2
 	XmlParser::Initialize();
@@ -44,6 +147,9 @@ static void LoadInternal(ExtensionLoader &loader) {
 
 	// Register bruteforce_find_sitemap() scalar function
 	RegisterBruteforceFunction(loader);
+
+	// Register diagnostics table functions
+	RegisterDiagnosticsFunctions(loader);
 }
 
 void SitemapExtension::Load(ExtensionLoader &loader) {
@@ -0,0 +1,277 @@
+#include "sitemap_filter.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/expression_filter.hpp"
+#include "duckdb/planner/filter/in_filter.hpp"
+
+namespace duckdb {
+
+SitemapEntryFilter::SitemapEntryFilter(const TableFilterSet &filters, const vector<column_t> &column_ids) {
+	for (auto &entry : filters.filters) {
+		auto column_id = column_ids[entry.first];
+		if (column_id >= SITEMAP_COLUMN_COUNT) {
+			continue;
+		}
+		auto &filter = *entry.second;
+
+		Predicate predicate;
+		if (TryConvert(filter, SITEMAP_COLUMN_FIELDS[column_id], predicate)) {
+			predicates.push_back(std::move(predicate));
+			continue;
+		}
+
+		BoundReferenceExpression column(LogicalType::VARCHAR, column_id);
+		auto expression = filter.ToExpression(column);
+		if (residual) {
+			residual = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND, std::move(residual),
+			                                                 std::move(expression));
+		} else {
+			residual = std::move(expression);
+		}
+	}
+}
+
+bool SitemapEntryFilter::TryConvert(const TableFilter &filter, std::string SitemapEntry::*field, Predicate &result) {
+	result.field = field;
+	switch (filter.filter_type) {
+	case TableFilterType::CONSTANT_COMPARISON: {
+		auto &constant_filter = filter.Cast<ConstantFilter>();
+		if (constant_filter.constant.IsNull() || constant_filter.constant.type().id() != LogicalTypeId::VARCHAR) {
+			return false;
+		}
+		switch (constant_filter.comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+		case ExpressionType::COMPARE_NOTEQUAL:
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			break;
+		default:
+			return false;
+		}
+		result.kind = Predicate::Kind::COMPARE;
+		result.comparison = constant_filter.comparison_type;
+		result.constant = StringValue::Get(constant_filter.constant);
+		return true;
+	}
+	case TableFilterType::IN_FILTER: {
+		auto &in_filter = filter.Cast<InFilter>();
+		for (auto &value : in_filter.values) {
+			if (value.IsNull() || value.type().id() != LogicalTypeId::VARCHAR) {
+				return false;
+			}
+			result.values.insert(StringValue::Get(value));
+		}
+		result.kind = Predicate::Kind::IN;
+		return true;
+	}
+	case TableFilterType::IS_NULL:
+		result.kind = Predicate::Kind::IS_NULL;
+		return true;
+	case TableFilterType::IS_NOT_NULL:
+		result.kind = Predicate::Kind::IS_NOT_NULL;
+		return true;
+	case TableFilterType::CONJUNCTION_AND:
+		result.kind = Predicate::Kind::AND;
+		return TryConvertChildren(filter.Cast<ConjunctionAndFilter>().child_filters, field, result);
+	case TableFilterType::CONJUNCTION_OR:
+		result.kind = Predicate::Kind::OR;
+		return TryConvertChildren(filter.Cast<ConjunctionOrFilter>().child_filters, field, result);
+	case TableFilterType::EXPRESSION_FILTER:
+		return TryConvertExpression(*filter.Cast<ExpressionFilter>().expr, result);
+	case TableFilterType::OPTIONAL_FILTER:
+	case TableFilterType::DYNAMIC_FILTER:
+		// Only hints (zone map pruning, top-N thresholds) - the result is correct without them
+		result.kind = Predicate::Kind::AND;
+		return true;
+	default:
+		return false;
+	}
+}
+
+// contains / prefix / suffix of the filtered column and a constant string
+bool SitemapEntryFilter::TryConvertExpression(const Expression &expression, Predicate &result) {
+	if (expression.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &function = expression.Cast<BoundFunctionExpression>();
+	auto &name = function.function.name;
+	if (name == "contains") {
+		result.kind = Predicate::Kind::CONTAINS;
+	} else if (name == "prefix" || name == "starts_with") {
+		result.kind = Predicate::Kind::PREFIX;
+	} else if (name == "suffix" || name == "ends_with") {
+		result.kind = Predicate::Kind::SUFFIX;
+	} else {
+		return false;
+	}
+	if (function.children.size() != 2 ||
+	    function.children[0]->GetExpressionClass() != ExpressionClass::BOUND_REF ||
+	    function.children[1]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	auto &constant = function.children[1]->Cast<BoundConstantExpression>().value;
+	if (constant.IsNull() || constant.type().id() != LogicalTypeId::VARCHAR) {
+		return false;
+	}
+	result.constant = StringValue::Get(constant);
+	return true;
+}
+
+bool SitemapEntryFilter::TryConvertChildren(const vector<unique_ptr<TableFilter>> &child_filters,
+                                            std::string SitemapEntry::*field, Predicate &result) {
+	for (auto &child_filter : child_filters) {
+		Predicate child;
+		if (!TryConvert(*child_filter, field, child)) {
+			return false;
+		}
+		result.children.push_back(std::move(child));
+	}
+	return true;
+}
+
+bool SitemapEntryFilter::Evaluate(const Predicate &predicate, const SitemapEntry &entry) {
+	auto &value = entry.*predicate.field;
+	switch (predicate.kind) {
+	case Predicate::Kind::COMPARE: {
+		if (value.empty()) {
+			return false; // NULL never compares true
+		}
+		auto cmp = value.compare(predicate.constant);
+		switch (predicate.comparison) {
+		case ExpressionType::COMPARE_EQUAL:
+			return cmp == 0;
+		case ExpressionType::COMPARE_NOTEQUAL:
+			return cmp != 0;
+		case ExpressionType::COMPARE_LESSTHAN:
+			return cmp < 0;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			return cmp <= 0;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			return cmp > 0;
+		default:
+			return cmp >= 0;
+		}
+	}
+	case Predicate::Kind::IN:
+		return !value.empty() && predicate.values.count(value) > 0;
+	case Predicate::Kind::IS_NULL:
+		return value.empty();
+	case Predicate::Kind::IS_NOT_NULL:
+		return !value.empty();
+	case Predicate::Kind::CONTAINS:
+		return !value.empty() && value.find(predicate.constant) != std::string::npos;
+	case Predicate::Kind::PREFIX:
+		return !value.empty() && value.compare(0, predicate.constant.size(), predicate.constant) == 0;
+	case Predicate::Kind::SUFFIX:
+		return !value.empty() && value.size() >= predicate.constant.size() &&
+		       value.compare(value.size() - predicate.constant.size(), predicate.constant.size(),
+		                     predicate.constant) == 0;
+	case Predicate::Kind::AND:
+		for (auto &child : predicate.children) {
+			if (!Evaluate(child, entry)) {
+				return false;
+			}
+		}
+		return true;
+	case Predicate::Kind::OR:
+		for (auto &child : predicate.children) {
+			if (Evaluate(child, entry)) {
+				return true;
+			}
+		}
+		return false;
+	default:
+		return true;
+	}
+}
+
+bool SitemapEntryFilter::Matches(const SitemapEntry &entry) const {
+	for (auto &predicate : predicates) {
+		if (!Evaluate(predicate, entry)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SitemapEntryFilter::CollectLowerBound(const Predicate &predicate, std::string SitemapEntry::*field, bool &found,
+                                           std::string &bound) {
+	if (predicate.kind == Predicate::Kind::AND) {
+		// Every child must hold, so each of them bounds the field
+		for (auto &child : predicate.children) {
+			CollectLowerBound(child, field, found, bound);
+		}
+		return;
+	}
+	if (predicate.kind != Predicate::Kind::COMPARE || predicate.field != field) {
+		return;
+	}
+	switch (predicate.comparison) {
+	case ExpressionType::COMPARE_EQUAL:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		if (!found || predicate.constant > bound) {
+			bound = predicate.constant;
+			found = true;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+bool SitemapEntryFilter::TryGetLowerBound(std::string SitemapEntry::*field, std::string &bound) const {
+	bool found = false;
+	for (auto &predicate : predicates) {
+		CollectLowerBound(predicate, field, found, bound);
+	}
+	return found;
+}
+
+SitemapResidualFilter::SitemapResidualFilter(ClientContext &context, const Expression &expression)
+    : executor(context, expression), sel(STANDARD_VECTOR_SIZE) {
+	vector<LogicalType> types(SITEMAP_COLUMN_COUNT, LogicalType::VARCHAR);
+	chunk.Initialize(Allocator::Get(context), types);
+}
+
+void SitemapResidualFilter::Apply(std::vector<SitemapEntry> &entries, idx_t start) {
+	idx_t out = start;
+	for (idx_t batch_start = start; batch_start < entries.size(); batch_start += STANDARD_VECTOR_SIZE) {
+		auto batch = MinValue<idx_t>(STANDARD_VECTOR_SIZE, entries.size() - batch_start);
+
+		// The chunk only references the entries' strings
+		chunk.Reset();
+		for (idx_t col = 0; col < SITEMAP_COLUMN_COUNT; col++) {
+			auto &vector = chunk.data[col];
+			auto data = FlatVector::GetData<string_t>(vector);
+			auto field = SITEMAP_COLUMN_FIELDS[col];
+			for (idx_t i = 0; i < batch; i++) {
+				auto &value = entries[batch_start + i].*field;
+				if (value.empty()) {
+					FlatVector::SetNull(vector, i, true);
+				} else {
+					data[i] = string_t(value.data(), static_cast<uint32_t>(value.size()));
+				}
+			}
+		}
+		chunk.SetCardinality(batch);
+
+		auto selected = executor.SelectExpression(chunk, sel);
+		for (idx_t i = 0; i < selected; i++) {
+			auto idx = batch_start + sel.get_index(i);
+			if (idx != out) {
+				entries[out] = std::move(entries[idx]);
+			}
+			out++;
+		}
+	}
+	entries.resize(out);
+}
+
+} // namespace duckdb
@@ -1,12 +1,23 @@
 #include "sitemap_function.hpp"
 #include "http_client.hpp"
+#include "fetch_engine.hpp"
+#include "response_cache.hpp"
 #include "robots_parser.hpp"
+#include "sitemap_cache.hpp"
+#include "sitemap_filter.hpp"
 #include "xml_parser.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/config.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/types/interval.hpp"
+#include "duckdb/common/types/timestamp.hpp"
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <unordered_map>
 
 namespace duckdb {
@@ -19,49 +30,142 @@ struct SitemapBindData : public TableFunctionData {
 	bool ignore_errors = false;
 	RetryConfig retry_config;
 	std::string user_agent;
+	idx_t concurrency = 8;
+	bool streaming_parser = true;
+	// Incremental crawl: skip child sitemaps whose index <lastmod> is older than this
+	bool has_modified_since = false;
+	timestamp_t modified_since;
+	// Discovery cache lifetimes (sitemap_cache_ttl / sitemap_cache_negative_ttl)
+	std::chrono::seconds cache_ttl {3600};
+	std::chrono::seconds cache_negative_ttl {300};
 };
 
-// Session-level cache for discovered sitemap URLs
-struct SitemapCache {
-	std::unordered_map<std::string, std::vector<std::string>> discovered_sitemaps;
-	std::mutex cache_mutex;
-
-	static SitemapCache &GetInstance() {
-		static SitemapCache instance;
-		return instance;
-	}
-
-	std::vector<std::string> Get(const std::string &base_url) {
-		std::lock_guard<std::mutex> lock(cache_mutex);
-		auto it = discovered_sitemaps.find(base_url);
-		if (it != discovered_sitemaps.end()) {
-			return it->second;
-		}
-		return {};
-	}
+// Per base URL bookkeeping, used to report base URLs that produced no entries
+struct BaseUrlProgress {
+	idx_t entry_count = 0;
+	idx_t pruned_sitemaps = 0;
+	idx_t pending_tasks = 0;
+	std::string last_error;
+};
 
-	void Set(const std::string &base_url, const std::vector<std::string> &sitemaps) {
-		std::lock_guard<std::mutex> lock(cache_mutex);
-		discovered_sitemaps[base_url] = sitemaps;
-	}
+// A fetched sitemap document waiting to be parsed by a scan thread
+struct FetchedSitemap {
+	std::string url;
+	idx_t base_idx = 0;
+	int depth = 0;
+	HttpResponse response;
 };
 
-// Global state for sitemap_urls() table function
+// Global state for sitemap_urls() table function. The FetchEngine keeps up to `concurrency`
+// sitemap requests in flight and queues fetched documents; DuckDB worker threads claim documents,
+// decompress and parse them, emit their rows through their local state and push nested index
+// entries back to the engine. Rows stream out while later sitemaps are still being fetched, and
+// memory is bounded by the document queue rather than by the site.
 struct SitemapGlobalState : public GlobalTableFunctionState {
-	std::vector<SitemapEntry> entries;
-	idx_t current_idx = 0;
+	std::deque<FetchedSitemap> documents;
+	idx_t max_queued_documents = 4;
+	idx_t max_threads = 1;
 	std::vector<std::string> errors;
+	std::vector<BaseUrlProgress> progress;
+	// Unfinished fetch tasks and unparsed documents, plus one held by init until every base URL is submitted
+	idx_t pending_tasks = 1;
 	bool fetch_complete = false;
+	std::atomic<bool> cancelled {false};
+	std::string fatal_error;
 	std::mutex mutex;
+	std::condition_variable data_cv;  // Document queued, fetch complete or fatal error
+	std::condition_variable space_cv; // Document taken or scan cancelled
+	unique_ptr<HttpSession> session;
+	unique_ptr<FetchEngine> engine;
+	unique_ptr<ResponseCache> response_cache; // nullptr unless sitemap_cache_dir is set
+	// Projected columns, the optional elements the parser has to extract for them, and pushed-down filters
+	vector<column_t> column_ids;
+	SitemapFields fields;
+	SitemapEntryFilter filter;
+	// Child sitemaps last modified before the cutoff are not fetched (modified_since or a lastmod filter)
+	bool prune_children = false;
+	timestamp_t children_cutoff;
+
+	~SitemapGlobalState() override {
+		// Scan finished early (e.g. LIMIT) - unblock producers and join them before members go away
+		Cancel();
+		engine.reset();
+	}
 
 	idx_t MaxThreads() const override {
-		return 1; // Single-threaded for HTTP fetching
+		return max_threads;
+	}
+
+	void Cancel() {
+		std::lock_guard<std::mutex> lock(mutex);
+		cancelled = true;
+		space_cv.notify_all();
+		data_cv.notify_all();
+	}
+
+	// Blocks while the queue is full. The queued document counts as pending work until a scan thread
+	// has parsed it. Returns false if the scan was cancelled.
+	bool PushDocument(FetchedSitemap document) {
+		std::unique_lock<std::mutex> lock(mutex);
+		space_cv.wait(lock, [&]() { return cancelled || documents.size() < max_queued_documents; });
+		if (cancelled) {
+			return false;
+		}
+		pending_tasks++;
+		progress[document.base_idx].pending_tasks++;
+		documents.push_back(std::move(document));
+		data_cv.notify_one();
+		return true;
+	}
+
+	// Blocks until a document is available. Returns false once all work is done and the queue is drained.
+	bool PopDocument(ClientContext &context, FetchedSitemap &document) {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			if (!fatal_error.empty()) {
+				throw IOException(fatal_error);
+			}
+			// A task that died without its completion bookkeeping would otherwise leave the scan waiting
+			engine->ThrowIfFailed();
+			if (!documents.empty()) {
+				document = std::move(documents.front());
+				documents.pop_front();
+				space_cv.notify_one();
+				return true;
+			}
+			if (fetch_complete) {
+				return false;
+			}
+			if (context.interrupted) {
+				throw InterruptException();
+			}
+			data_cv.wait_for(lock, std::chrono::milliseconds(100));
+		}
+	}
+
+	bool HasDocument() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return !documents.empty();
 	}
 };
 
 // Local state for per-thread execution
 struct SitemapLocalState : public LocalTableFunctionState {
-	idx_t local_idx = 0;
+	// Parsed entries not yet emitted
+	std::vector<SitemapEntry> entries;
+	idx_t entry_idx = 0;
+
+	// Document this thread is parsing. The reader gunzips the body in 32 KB chunks that go straight
+	// into the streaming parser, which is only fed until a chunk of entries is materialized.
+	bool has_document = false;
+	FetchedSitemap document;
+	std::string content;
+	unique_ptr<GzipStreamReader> reader;
+	unique_ptr<SitemapStreamParser> parser;
+	// Entries parsed so far, including those rejected by pushed-down filters
+	idx_t parsed_entries = 0;
+	// Pushed-down filters that have to be evaluated as an expression
+	unique_ptr<SitemapResidualFilter> residual_filter;
 };
 
 // Build full URL from base and path
@@ -79,51 +183,237 @@ static std::string BuildUrl(const std::string &base_url, const std::string &path
 	return base + path;
 }
 
-// Fetch and process a single sitemap (may be urlset or sitemapindex)
-static void FetchSitemap(ClientContext &context, const std::string &sitemap_url, SitemapGlobalState &state,
-                         const SitemapBindData &bind_data, int current_depth) {
-	if (current_depth > bind_data.max_depth) {
-		return; // Prevent infinite recursion
+static void AddError(SitemapGlobalState &state, idx_t base_idx, std::string error) {
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.progress[base_idx].last_error = error;
+	state.errors.push_back(std::move(error));
+}
+
+// Completion bookkeeping for a task or document of a base URL. The last one of a base URL that
+// produced no entries fails the scan unless ignore_errors is set; the last one overall completes it.
+static void FinishTask(SitemapGlobalState &state, const SitemapBindData &bind_data, idx_t base_idx) {
+	std::lock_guard<std::mutex> lock(state.mutex);
+	auto &progress = state.progress[base_idx];
+	progress.pending_tasks--;
+	if (progress.pending_tasks == 0 && progress.entry_count == 0 && progress.pruned_sitemaps == 0 &&
+	    !bind_data.ignore_errors && state.fatal_error.empty()) {
+		state.fatal_error = "Failed to find sitemap for " + bind_data.base_urls[base_idx];
+		if (!progress.last_error.empty()) {
+			// Include the last error message
+			state.fatal_error += ": " + progress.last_error;
+		}
+		state.data_cv.notify_all();
 	}
 
-	auto response = HttpClient::Fetch(context, sitemap_url, bind_data.retry_config, bind_data.user_agent);
+	state.pending_tasks--;
+	if (state.pending_tasks == 0) {
+		state.fetch_complete = true;
+		state.data_cv.notify_all();
+	}
+}
 
-	if (!response.success) {
+static void SubmitTask(SitemapGlobalState &state, const SitemapBindData &bind_data, idx_t base_idx,
+                       std::function<void()> task) {
+	{
 		std::lock_guard<std::mutex> lock(state.mutex);
-		state.errors.push_back("Failed to fetch " + sitemap_url + ": " + response.error);
+		state.pending_tasks++;
+		state.progress[base_idx].pending_tasks++;
+	}
+	state.engine->Submit([&state, &bind_data, base_idx, task]() {
+		if (!state.cancelled) {
+			try {
+				task();
+			} catch (std::exception &ex) {
+				ErrorData error(ex);
+				AddError(state, base_idx, error.RawMessage());
+			}
+		}
+		FinishTask(state, bind_data, base_idx);
+	});
+}
+
+// GET through the persistent response cache when one is configured
+static HttpResponse FetchDocument(SitemapGlobalState &state, const std::string &url, const RetryConfig &config) {
+	if (state.response_cache) {
+		return state.response_cache->Fetch(*state.session, url, config);
+	}
+	return HttpClient::Fetch(*state.session, url, config);
+}
+
+// Queue a fetched sitemap for parsing
+static void QueueDocument(SitemapGlobalState &state, const std::string &sitemap_url, idx_t base_idx, int depth,
+                          HttpResponse response) {
+	FetchedSitemap document;
+	document.url = sitemap_url;
+	document.base_idx = base_idx;
+	document.depth = depth;
+	document.response = std::move(response);
+	state.PushDocument(std::move(document));
+}
+
+// Fetch a single sitemap on a FetchEngine worker and queue it for parsing
+static void FetchSitemap(const std::string &sitemap_url, SitemapGlobalState &state, const SitemapBindData &bind_data,
+                         idx_t base_idx, int current_depth) {
+	// A remote sitemap or robots.txt must not make the scan read local files
+	if (HttpSession::IsFileUrl(sitemap_url) && !HttpSession::IsFileUrl(bind_data.base_urls[base_idx])) {
+		AddError(state, base_idx, "Refusing to read local sitemap " + sitemap_url + " for remote " +
+		                              bind_data.base_urls[base_idx]);
 		return;
 	}
+	// Stop retrying once the scan is done (e.g. LIMIT), so teardown does not wait out the backoff
+	auto config = bind_data.retry_config;
+	config.is_cancelled = [&state]() {
+		return state.cancelled.load();
+	};
+	auto response = FetchDocument(state, sitemap_url, config);
 
-	// Check if gzipped and decompress
-	std::string content = response.body;
-	if (XmlParser::IsGzipped(sitemap_url, response.content_type)) {
-		content = XmlParser::DecompressGzip(response.body);
-		if (content.empty()) {
-			std::lock_guard<std::mutex> lock(state.mutex);
-			state.errors.push_back("Failed to decompress gzipped sitemap: " + sitemap_url);
-			return;
-		}
+	if (!response.success) {
+		AddError(state, base_idx, "Failed to fetch " + sitemap_url + ": " + response.error);
+		return;
 	}
+	QueueDocument(state, sitemap_url, base_idx, current_depth, std::move(response));
+}
 
-	// Parse the sitemap
-	auto result = XmlParser::ParseSitemap(content);
+// W3C datetime as used by <lastmod>: a date, or a date and time with an optional UTC offset
+static bool TryParseLastmod(const std::string &lastmod, timestamp_t &result) {
+	return Timestamp::TryConvertTimestamp(lastmod.c_str(), lastmod.size(), result) == TimestampCastResult::SUCCESS;
+}
+
+// The index <lastmod> of a child is trusted: a child last modified before the cutoff cannot contain
+// newer entries. Children without a (parseable) lastmod are always fetched.
+static bool IsPrunedChild(const SitemapGlobalState &state, const SitemapIndexEntry &child) {
+	timestamp_t lastmod;
+	return state.prune_children && TryParseLastmod(child.lastmod, lastmod) && lastmod < state.children_cutoff;
+}
 
-	if (!result.success) {
+static void SubmitChildSitemap(SitemapGlobalState &state, const SitemapBindData &bind_data, idx_t base_idx,
+                               int current_depth, SitemapIndexEntry child) {
+	// Sitemap index - fetch child sitemaps (depth limit prevents infinite recursion)
+	if (current_depth >= bind_data.max_depth) {
+		return;
+	}
+	if (IsPrunedChild(state, child)) {
 		std::lock_guard<std::mutex> lock(state.mutex);
-		state.errors.push_back("Failed to parse sitemap " + sitemap_url + ": " + result.error);
+		state.progress[base_idx].pruned_sitemaps++;
 		return;
 	}
+	auto child_url = std::move(child.loc);
+	SubmitTask(state, bind_data, base_idx, [&state, &bind_data, child_url, base_idx, current_depth]() {
+		FetchSitemap(child_url, state, bind_data, base_idx, current_depth + 1);
+	});
+}
 
-	if (result.type == SitemapType::URLSET) {
-		// Add URLs to state
-		std::lock_guard<std::mutex> lock(state.mutex);
-		state.entries.insert(state.entries.end(), result.urls.begin(), result.urls.end());
-	} else {
-		// Sitemap index - recursively fetch child sitemaps
-		for (const auto &child_url : result.sitemaps) {
-			FetchSitemap(context, child_url, state, bind_data, current_depth + 1);
+static void AddEntryCount(SitemapGlobalState &state, idx_t base_idx, idx_t count) {
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.progress[base_idx].entry_count += count;
+}
+
+// Done with the local document: release it and its pending-work slot
+static void FinishDocument(SitemapGlobalState &state, const SitemapBindData &bind_data,
+                           SitemapLocalState &local_state) {
+	auto base_idx = local_state.document.base_idx;
+	local_state.has_document = false;
+	local_state.parser.reset();
+	local_state.reader.reset();
+	local_state.content = std::string();
+	local_state.document = FetchedSitemap();
+	FinishTask(state, bind_data, base_idx);
+}
+
+// Apply the pushed-down filters to the entries from start onwards
+static void FilterEntries(SitemapGlobalState &state, SitemapLocalState &local_state, idx_t start) {
+	auto &entries = local_state.entries;
+	auto end = std::remove_if(entries.begin() + static_cast<std::ptrdiff_t>(start), entries.end(),
+	                          [&state](const SitemapEntry &entry) { return !state.filter.Matches(entry); });
+	entries.erase(end, entries.end());
+	if (local_state.residual_filter) {
+		local_state.residual_filter->Apply(entries, start);
+	}
+}
+
+// Take ownership of a fetched sitemap (may be urlset or sitemapindex) on a scan thread. Gzipped bodies
+// are recognized by their magic bytes and inflated incrementally while they are parsed.
+static void StartDocument(FetchedSitemap document, SitemapGlobalState &state, const SitemapBindData &bind_data,
+                          SitemapLocalState &local_state) {
+	local_state.has_document = true;
+	local_state.document = std::move(document);
+	local_state.content = std::move(local_state.document.response.body);
+	local_state.reader = make_uniq<GzipStreamReader>(local_state.content);
+
+	auto &sitemap_url = local_state.document.url;
+	auto base_idx = local_state.document.base_idx;
+	auto depth = local_state.document.depth;
+
+	if (!bind_data.streaming_parser) {
+		// DOM parser - the whole document at once
+		auto result = XmlParser::ParseSitemap(*local_state.reader, state.fields);
+		if (!local_state.reader->Error().empty()) {
+			AddError(state, base_idx,
+			         "Failed to decompress gzipped sitemap " + sitemap_url + ": " + local_state.reader->Error());
+		} else if (!result.success) {
+			AddError(state, base_idx, "Failed to parse sitemap " + sitemap_url + ": " + result.error);
+		} else if (result.type == SitemapType::URLSET) {
+			AddEntryCount(state, base_idx, result.urls.size());
+			local_state.entries = std::move(result.urls);
+			FilterEntries(state, local_state, 0);
+		} else {
+			for (auto &child : result.sitemaps) {
+				SubmitChildSitemap(state, bind_data, base_idx, depth, std::move(child));
+			}
+		}
+		FinishDocument(state, bind_data, local_state);
+		return;
+	}
+
+	// Entries rejected by the pushed-down string filters are never buffered; the parser reuses their strings
+	local_state.parser = make_uniq<SitemapStreamParser>(
+	    [&state, &local_state](SitemapEntry &entry) {
+		    local_state.parsed_entries++;
+		    if (state.filter.Matches(entry)) {
+			    local_state.entries.push_back(std::move(entry));
+		    }
+	    },
+	    [&state, &bind_data, base_idx, depth](SitemapIndexEntry &child) {
+		    SubmitChildSitemap(state, bind_data, base_idx, depth, std::move(child));
+	    },
+	    state.fields);
+}
+
+// Feed the streaming parser until a chunk worth of entries is ready or the document ends
+static void ContinueDocument(SitemapGlobalState &state, const SitemapBindData &bind_data,
+                             SitemapLocalState &local_state) {
+	auto &reader = *local_state.reader;
+	auto &parser = *local_state.parser;
+	auto base_idx = local_state.document.base_idx;
+	idx_t entries_before = local_state.entries.size();
+	idx_t parsed_before = local_state.parsed_entries;
+
+	bool ok = true;
+	bool has_more = true;
+	while (ok && local_state.entries.size() < STANDARD_VECTOR_SIZE) {
+		const char *data;
+		size_t size;
+		if (!reader.Read(data, size)) {
+			has_more = false;
+			break;
 		}
+		ok = parser.Feed(data, size);
+	}
+	AddEntryCount(state, base_idx, local_state.parsed_entries - parsed_before);
+	if (local_state.residual_filter) {
+		local_state.residual_filter->Apply(local_state.entries, entries_before);
+	}
+
+	if (ok && has_more) {
+		return; // More to parse once these entries are emitted
+	}
+	if (!reader.Error().empty()) {
+		AddError(state, base_idx,
+		         "Failed to decompress gzipped sitemap " + local_state.document.url + ": " + reader.Error());
+	} else if (!ok || !parser.Finish()) {
+		AddError(state, base_idx, "Failed to parse sitemap " + local_state.document.url + ": " + parser.Error());
 	}
+	FinishDocument(state, bind_data, local_state);
 }
 
 // Bind function
@@ -174,6 +464,27 @@ static unique_ptr<FunctionData> SitemapBind(ClientContext &context, TableFunctio
 		bind_data->user_agent = user_agent_value.GetValue<std::string>();
 	}
 
+	// Get XML parser mode from extension setting
+	Value parser_value;
+	if (context.TryGetCurrentSetting("sitemap_xml_parser", parser_value)) {
+		bind_data->streaming_parser = StringUtil::Lower(parser_value.GetValue<std::string>()) != "dom";
+	}
+
+	// Get default request concurrency from extension setting
+	Value concurrency_value;
+	if (context.TryGetCurrentSetting("sitemap_max_concurrency", concurrency_value)) {
+		bind_data->concurrency = static_cast<idx_t>(concurrency_value.GetValue<int64_t>());
+	}
+
+	// Get discovery cache lifetimes from extension settings
+	Value ttl_value;
+	if (context.TryGetCurrentSetting("sitemap_cache_ttl", ttl_value)) {
+		bind_data->cache_ttl = std::chrono::seconds(ttl_value.GetValue<int64_t>());
+	}
+	if (context.TryGetCurrentSetting("sitemap_cache_negative_ttl", ttl_value)) {
+		bind_data->cache_negative_ttl = std::chrono::seconds(ttl_value.GetValue<int64_t>());
+	}
+
 	// Parse named parameters
 	for (auto &kv : input.named_parameters) {
 		auto key = StringUtil::Lower(kv.first);
@@ -189,6 +500,17 @@ static unique_ptr<FunctionData> SitemapBind(ClientContext &context, TableFunctio
 			bind_data->retry_config.max_backoff_ms = kv.second.GetValue<int>();
 		} else if (key == "ignore_errors") {
 			bind_data->ignore_errors = kv.second.GetValue<bool>();
+		} else if (key == "concurrency") {
+			auto concurrency = kv.second.GetValue<int64_t>();
+			if (concurrency < 1) {
+				throw InvalidInputException("sitemap_urls() concurrency must be at least 1");
+			}
+			bind_data->concurrency = static_cast<idx_t>(concurrency);
+		} else if (key == "modified_since") {
+			if (!kv.second.IsNull()) {
+				bind_data->has_modified_since = true;
+				bind_data->modified_since = kv.second.GetValue<timestamp_t>();
+			}
 		}
 	}
 
@@ -211,146 +533,341 @@ static bool IsSitemapUrl(const std::string &url) {
 	        lower_url.find(".xml.gz") != std::string::npos);
 }
 
-// Discover sitemap URLs for a base URL using multiple fallback methods
-static std::vector<std::string> DiscoverSitemapUrls(ClientContext &context, const std::string &base_url,
-                                                     const SitemapBindData &bind_data) {
-	auto &cache = SitemapCache::GetInstance();
+// Discovery fallbacks in order of precedence
+enum class DiscoveryProbe : uint8_t { ROBOTS_TXT, SITEMAP_XML, SITEMAP_INDEX_XML, HOMEPAGE };
 
-	// If URL points directly to sitemap, use it without discovery
-	if (IsSitemapUrl(base_url)) {
-		return {base_url};
+// Discovery of one base URL. All fallbacks are probed at once; the PriorityResolver picks the first
+// successful probe in precedence order, so the result is the same as trying them one after another.
+// Probes behind the best success so far are cancelled.
+struct BaseUrlDiscovery {
+	explicit BaseUrlDiscovery(std::vector<DiscoveryProbe> probes_p)
+	    : probes(std::move(probes_p)), resolver(probes.size()), sitemap_urls(probes.size()),
+	      responses(probes.size()) {
 	}
 
-	// Check cache first
-	auto cached = cache.Get(base_url);
-	if (!cached.empty()) {
-		return cached;
+	std::vector<DiscoveryProbe> probes;
+	PriorityResolver resolver;
+	// Per probe results; only the winner's are used
+	std::vector<std::vector<std::string>> sitemap_urls;
+	std::vector<HttpResponse> responses; // Downloaded sitemap of the sitemap.xml / sitemap_index.xml probes
+	// robots.txt Crawl-delay, cached with the result; set before the robots.txt probe reports
+	double crawl_delay = 0;
+	// Network errors and 5xx do not prove that the site has no sitemap
+	std::atomic<bool> transient_failure {false};
+};
+
+// Submit fetches for discovered sitemaps; a sitemap discovery already downloaded goes straight to parsing
+static void SubmitSitemaps(SitemapGlobalState &state, const SitemapBindData &bind_data, idx_t base_idx,
+                           const std::vector<std::string> &sitemap_urls, HttpResponse prefetched) {
+	for (idx_t i = 0; i < sitemap_urls.size(); i++) {
+		auto &sitemap_url = sitemap_urls[i];
+		if (i == 0 && prefetched.success) {
+			QueueDocument(state, sitemap_url, base_idx, 0, std::move(prefetched));
+			continue;
+		}
+		SubmitTask(state, bind_data, base_idx, [&state, &bind_data, sitemap_url, base_idx]() {
+			FetchSitemap(sitemap_url, state, bind_data, base_idx, 0);
+		});
 	}
+}
 
-	std::vector<std::string> sitemap_urls;
+// Run one discovery probe. Returns true if it found sitemaps.
+static bool RunDiscoveryProbe(SitemapGlobalState &state, const SitemapBindData &bind_data, idx_t base_idx,
+                              BaseUrlDiscovery &discovery, idx_t probe_idx) {
+	auto &session = *state.session;
+	auto &base_url = bind_data.base_urls[base_idx];
+	auto &sitemap_urls = discovery.sitemap_urls[probe_idx];
+
+	// Give up once a probe of higher precedence has found sitemaps
+	auto config = bind_data.retry_config;
+	config.is_cancelled = [&state, &discovery, probe_idx]() {
+		return state.cancelled || discovery.resolver.IsCancelled(probe_idx);
+	};
+	auto check_transient = [&](const HttpResponse &response) {
+		if (!response.success && (response.status_code <= 0 || response.status_code >= 500)) {
+			discovery.transient_failure = true;
+		}
+	};
 
-	// 1. Try robots.txt
-	if (bind_data.follow_robots) {
+	switch (discovery.probes[probe_idx]) {
+	case DiscoveryProbe::ROBOTS_TXT: {
 		std::string robots_url = BuildUrl(base_url, "/robots.txt");
-		auto response = HttpClient::Fetch(context, robots_url, bind_data.retry_config, bind_data.user_agent);
-
-		if (response.success) {
-			sitemap_urls = RobotsParser::ParseSitemapUrls(response.body);
-			if (!sitemap_urls.empty()) {
-				cache.Set(base_url, sitemap_urls);
-				return sitemap_urls;
-			}
+		auto response = HttpClient::Fetch(session, robots_url, config);
+		check_transient(response);
+		if (!response.success) {
+			return false;
 		}
+		// Honor Crawl-delay for every later request to this host
+		auto crawl_delay = RobotsParser::ParseCrawlDelay(response.body, session.UserAgent());
+		if (crawl_delay > 0) {
+			HostScheduler::GetInstance().SetCrawlDelay(HostScheduler::ExtractHost(robots_url), crawl_delay);
+			discovery.crawl_delay = crawl_delay;
+		}
+		sitemap_urls = RobotsParser::ParseSitemapUrls(response.body);
+		return !sitemap_urls.empty();
 	}
-
-	// 2. Try /sitemap.xml
-	std::string sitemap_xml_url = BuildUrl(base_url, "/sitemap.xml");
-	auto sitemap_response = HttpClient::Fetch(context, sitemap_xml_url, bind_data.retry_config, bind_data.user_agent);
-	if (sitemap_response.success) {
-		sitemap_urls.push_back(sitemap_xml_url);
-		cache.Set(base_url, sitemap_urls);
-		return sitemap_urls;
-	}
-
-	// 3. Try /sitemap_index.xml
-	std::string sitemap_index_url = BuildUrl(base_url, "/sitemap_index.xml");
-	auto index_response = HttpClient::Fetch(context, sitemap_index_url, bind_data.retry_config, bind_data.user_agent);
-	if (index_response.success) {
-		sitemap_urls.push_back(sitemap_index_url);
-		cache.Set(base_url, sitemap_urls);
-		return sitemap_urls;
-	}
-
-	// 4. Try parsing HTML from homepage
-	std::string homepage_url = base_url;
-	auto html_response = HttpClient::Fetch(context, homepage_url, bind_data.retry_config, bind_data.user_agent);
-	if (html_response.success) {
-		auto html_sitemaps = XmlParser::FindSitemapInHtml(html_response.body);
-		if (!html_sitemaps.empty()) {
-			// Convert relative URLs to absolute
-			for (auto &sitemap_url : html_sitemaps) {
-				if (sitemap_url.find("://") == std::string::npos) {
-					// Relative URL - make it absolute
-					if (sitemap_url[0] == '/') {
-						sitemap_url = base_url + sitemap_url;
-					} else {
-						sitemap_url = base_url + "/" + sitemap_url;
-					}
+	case DiscoveryProbe::SITEMAP_XML:
+	case DiscoveryProbe::SITEMAP_INDEX_XML: {
+		auto path = discovery.probes[probe_idx] == DiscoveryProbe::SITEMAP_XML ? "/sitemap.xml" : "/sitemap_index.xml";
+		std::string sitemap_url = BuildUrl(base_url, path);
+		auto response = FetchDocument(state, sitemap_url, config);
+		check_transient(response);
+		if (!response.success) {
+			return false;
+		}
+		sitemap_urls.push_back(sitemap_url);
+		discovery.responses[probe_idx] = std::move(response);
+		return true;
+	}
+	case DiscoveryProbe::HOMEPAGE: {
+		// <link rel="sitemap"> and similar references in the homepage HTML
+		auto response = HttpClient::Fetch(session, base_url, config);
+		check_transient(response);
+		if (!response.success) {
+			return false;
+		}
+		for (auto &sitemap_url : XmlParser::FindSitemapInHtml(response.body)) {
+			if (sitemap_url.find("://") == std::string::npos) {
+				// Relative URL - make it absolute
+				if (sitemap_url[0] == '/') {
+					sitemap_url = base_url + sitemap_url;
+				} else {
+					sitemap_url = base_url + "/" + sitemap_url;
 				}
-				sitemap_urls.push_back(sitemap_url);
 			}
-			cache.Set(base_url, sitemap_urls);
-			return sitemap_urls;
+			sitemap_urls.push_back(sitemap_url);
+		}
+		return !sitemap_urls.empty();
+	}
+	default:
+		return false;
+	}
+}
+
+// Discovery results depend on whether robots.txt was consulted, so each mode gets its own cache entry
+static std::string DiscoveryCacheKey(const SitemapBindData &bind_data, idx_t base_idx) {
+	auto &base_url = bind_data.base_urls[base_idx];
+	return bind_data.follow_robots ? base_url : base_url + "\nfollow_robots=false";
+}
+
+// Called once the resolver has decided: cache the outcome and start fetching the winner's sitemaps
+static void FinishDiscovery(SitemapGlobalState &state, const SitemapBindData &bind_data, idx_t base_idx,
+                            BaseUrlDiscovery &discovery) {
+	auto &cache = SitemapCache::GetInstance();
+	auto cache_key = DiscoveryCacheKey(bind_data, base_idx);
+	auto winner = discovery.resolver.Winner();
+	if (winner == DConstants::INVALID_INDEX) {
+		// Nothing found - only a definitive "not found" is cached (will trigger error if ignore_errors=false)
+		if (!discovery.transient_failure) {
+			cache.Set(cache_key, std::vector<std::string>(), bind_data.cache_negative_ttl);
+		}
+		return;
+	}
+	auto &sitemap_urls = discovery.sitemap_urls[winner];
+	cache.Set(cache_key, sitemap_urls, bind_data.cache_ttl, discovery.crawl_delay);
+	SubmitSitemaps(state, bind_data, base_idx, sitemap_urls, std::move(discovery.responses[winner]));
+}
+
+// Discover the sitemaps of one base URL and queue them for fetching. Discovery of other base URLs runs
+// concurrently on the same FetchEngine.
+static void ProcessBaseUrl(SitemapGlobalState &state, const SitemapBindData &bind_data, idx_t base_idx) {
+	auto &base_url = bind_data.base_urls[base_idx];
+
+	// If URL points directly to sitemap, use it without discovery
+	if (IsSitemapUrl(base_url)) {
+		SubmitSitemaps(state, bind_data, base_idx, {base_url}, HttpResponse());
+		return;
+	}
+
+	// Check cache first - a negative entry means discovery recently found nothing
+	std::vector<std::string> sitemap_urls;
+	double crawl_delay = 0;
+	auto lookup = SitemapCache::GetInstance().Get(DiscoveryCacheKey(bind_data, base_idx), sitemap_urls, crawl_delay);
+	if (lookup != SitemapCache::LookupResult::MISS) {
+		// The host may have been forgotten since robots.txt was read; its Crawl-delay still applies
+		if (crawl_delay > 0) {
+			HostScheduler::GetInstance().SetCrawlDelay(HostScheduler::ExtractHost(base_url), crawl_delay);
 		}
+		SubmitSitemaps(state, bind_data, base_idx, sitemap_urls, HttpResponse());
+		return;
 	}
 
-	// Nothing found - return empty (will trigger error if ignore_errors=false)
-	return sitemap_urls;
+	std::vector<DiscoveryProbe> probes;
+	if (bind_data.follow_robots) {
+		probes.push_back(DiscoveryProbe::ROBOTS_TXT);
+	}
+	probes.push_back(DiscoveryProbe::SITEMAP_XML);
+	probes.push_back(DiscoveryProbe::SITEMAP_INDEX_XML);
+	probes.push_back(DiscoveryProbe::HOMEPAGE);
+
+	auto discovery = make_shared_ptr<BaseUrlDiscovery>(std::move(probes));
+	for (idx_t probe_idx = 0; probe_idx < discovery->probes.size(); probe_idx++) {
+		SubmitTask(state, bind_data, base_idx, [&state, &bind_data, base_idx, discovery, probe_idx]() {
+			bool found = false;
+			if (!discovery->resolver.IsCancelled(probe_idx)) {
+				try {
+					found = RunDiscoveryProbe(state, bind_data, base_idx, *discovery, probe_idx);
+				} catch (std::exception &) {
+					discovery->transient_failure = true;
+				}
+			}
+			// The probe that decides the outcome continues in this task, so the base URL stays pending
+			if (discovery->resolver.Report(probe_idx, found)) {
+				FinishDiscovery(state, bind_data, base_idx, *discovery);
+			}
+		});
+	}
 }
 
-// Global init - fetch all sitemaps
+// Global init - start discovery and fetching; rows are produced in the background
 static unique_ptr<GlobalTableFunctionState> SitemapInitGlobal(ClientContext &context, TableFunctionInitInput &input) {
 	auto state = make_uniq<SitemapGlobalState>();
 	auto &bind_data = input.bind_data->Cast<SitemapBindData>();
+	state->session = make_uniq<HttpSession>(context, bind_data.user_agent);
+	for (auto &base_url : bind_data.base_urls) {
+		state->session->CheckSupported(base_url);
+	}
+	state->response_cache = ResponseCache::TryCreate(context);
+	state->progress.resize(bind_data.base_urls.size());
+	state->engine = make_uniq<FetchEngine>(bind_data.concurrency);
+
+	// Projection pushdown: skip child elements of <url> no selected column reads
+	state->column_ids = input.column_ids;
+	state->fields.lastmod = false;
+	state->fields.changefreq = false;
+	state->fields.priority = false;
+	for (auto column_id : state->column_ids) {
+		if (column_id == SITEMAP_COLUMN_LASTMOD) {
+			state->fields.lastmod = true;
+		} else if (column_id == SITEMAP_COLUMN_CHANGEFREQ) {
+			state->fields.changefreq = true;
+		} else if (column_id == SITEMAP_COLUMN_PRIORITY) {
+			state->fields.priority = true;
+		}
+	}
 
-	// Process each base URL
-	for (const auto &base_url : bind_data.base_urls) {
-		// Discover sitemap URLs using fallback methods
-		std::vector<std::string> sitemap_urls = DiscoverSitemapUrls(context, base_url, bind_data);
-
-		// Track initial error count
-		size_t initial_error_count = state->errors.size();
-		size_t initial_entry_count = state->entries.size();
+	// Filter pushdown: filter columns are part of column_ids, so the mask above covers them
+	if (input.filters) {
+		state->filter = SitemapEntryFilter(*input.filters, state->column_ids);
+	}
 
-		// Fetch all sitemaps for this base URL
-		for (const auto &sitemap_url : sitemap_urls) {
-			FetchSitemap(context, sitemap_url, *state, bind_data, 0);
+	// Incremental crawl cutoff: modified_since, or the lower bound of a pushed-down lastmod filter
+	if (bind_data.has_modified_since) {
+		state->prune_children = true;
+		state->children_cutoff = bind_data.modified_since;
+	}
+	std::string lastmod_bound;
+	timestamp_t lastmod_cutoff;
+	if (state->filter.TryGetLowerBound(&SitemapEntry::lastmod, lastmod_bound) &&
+	    TryParseLastmod(lastmod_bound, lastmod_cutoff)) {
+		// The filter compares strings, i.e. local times, while a child's lastmod is compared in UTC. An entry's
+		// UTC offset and the bound's own can each move its string up to 14 hours away from its instant, so
+		// only children older than the bound by more than that cannot hold a passing entry.
+		static constexpr int64_t MAX_UTC_OFFSET_MICROS = 14 * Interval::MICROS_PER_HOUR;
+		lastmod_cutoff = timestamp_t(lastmod_cutoff.value - 2 * MAX_UTC_OFFSET_MICROS);
+		if (!state->prune_children || lastmod_cutoff > state->children_cutoff) {
+			state->children_cutoff = lastmod_cutoff;
 		}
+		state->prune_children = true;
+	}
 
-		// Check if any URLs were found for this base_url
-		bool found_urls = state->entries.size() > initial_entry_count;
-		bool had_errors = state->errors.size() > initial_error_count;
+	// Parse on every DuckDB thread; keep enough fetched documents queued to keep them busy
+	auto scheduler_threads = TaskScheduler::GetScheduler(context).NumberOfThreads();
+	state->max_threads = MaxValue<idx_t>(1, static_cast<idx_t>(scheduler_threads));
+	state->max_queued_documents = MaxValue<idx_t>(4, 2 * state->max_threads);
 
-		// If no URLs found and not ignoring errors, throw exception
-		if (!found_urls && !bind_data.ignore_errors) {
-			std::string error_msg = "Failed to find sitemap for " + base_url;
-			if (had_errors && !state->errors.empty()) {
-				// Include the last error message
-				error_msg += ": " + state->errors.back();
-			}
-			throw IOException(error_msg);
-		}
+	auto &state_ref = *state;
+	for (idx_t base_idx = 0; base_idx < bind_data.base_urls.size(); base_idx++) {
+		SubmitTask(state_ref, bind_data, base_idx,
+		           [&state_ref, &bind_data, base_idx]() { ProcessBaseUrl(state_ref, bind_data, base_idx); });
 	}
 
-	state->fetch_complete = true;
+	// Release the submission guard
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->pending_tasks--;
+		if (state->pending_tasks == 0) {
+			state->fetch_complete = true;
+		}
+	}
 	return std::move(state);
 }
 
 // Local init
 static unique_ptr<LocalTableFunctionState> SitemapInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
                                                              GlobalTableFunctionState *global_state) {
-	return make_uniq<SitemapLocalState>();
+	auto &state = global_state->Cast<SitemapGlobalState>();
+	auto local_state = make_uniq<SitemapLocalState>();
+	if (state.filter.Residual()) {
+		local_state->residual_filter = make_uniq<SitemapResidualFilter>(context.client, *state.filter.Residual());
+	}
+	return std::move(local_state);
+}
+
+// Empty fields (missing optional elements) are NULL
+static void WriteField(Vector &vector, string_t *data, idx_t row, const std::string &value) {
+	if (value.empty()) {
+		FlatVector::SetNull(vector, row, true);
+		return;
+	}
+	data[row] = StringVector::AddString(vector, value);
 }
 
-// Scan function - return entries in batches
+// Scan function - claim fetched documents, parse them and emit their entries
 static void SitemapScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<SitemapBindData>();
 	auto &state = data.global_state->Cast<SitemapGlobalState>();
+	auto &local_state = data.local_state->Cast<SitemapLocalState>();
 
 	idx_t count = 0;
 	idx_t max_count = STANDARD_VECTOR_SIZE;
 
-	while (count < max_count && state.current_idx < state.entries.size()) {
-		auto &entry = state.entries[state.current_idx];
+	while (count < max_count) {
+		if (local_state.entry_idx >= local_state.entries.size()) {
+			local_state.entries.clear();
+			local_state.entry_idx = 0;
 
-		output.SetValue(0, count, Value(entry.url));
-		output.SetValue(1, count, entry.lastmod.empty() ? Value() : Value(entry.lastmod));
-		output.SetValue(2, count, entry.changefreq.empty() ? Value() : Value(entry.changefreq));
-		output.SetValue(3, count, entry.priority.empty() ? Value() : Value(entry.priority));
+			if (local_state.has_document) {
+				ContinueDocument(state, bind_data, local_state);
+				continue;
+			}
+			// Emit a partial chunk rather than wait for the next sitemap
+			if (count > 0 && !state.HasDocument()) {
+				break;
+			}
+			FetchedSitemap document;
+			if (!state.PopDocument(context, document)) {
+				break;
+			}
+			StartDocument(std::move(document), state, bind_data, local_state);
+			continue;
+		}
 
-		state.current_idx++;
-		count++;
+		// Copy every buffered entry that fits in this chunk, one projected column at a time. Short strings
+		// are inlined, longer ones copied once into the vector's string heap.
+		auto batch = MinValue<idx_t>(max_count - count, local_state.entries.size() - local_state.entry_idx);
+		for (idx_t col = 0; col < state.column_ids.size(); col++) {
+			auto column_id = state.column_ids[col];
+			if (column_id >= SITEMAP_COLUMN_COUNT) {
+				continue; // Row id or empty projection (e.g. count(*)); set below
+			}
+			auto &vector = output.data[col];
+			auto vector_data = FlatVector::GetData<string_t>(vector);
+			auto field = SITEMAP_COLUMN_FIELDS[column_id];
+			for (idx_t i = 0; i < batch; i++) {
+				WriteField(vector, vector_data, count + i, local_state.entries[local_state.entry_idx + i].*field);
+			}
+		}
+		local_state.entry_idx += batch;
+		count += batch;
 	}
 
+	for (idx_t col = 0; col < state.column_ids.size(); col++) {
+		if (state.column_ids[col] >= SITEMAP_COLUMN_COUNT) {
+			output.data[col].SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(output.data[col], true);
+		}
+	}
 	output.SetCardinality(count);
 }
 
@@ -358,6 +875,8 @@ void RegisterSitemapFunction(ExtensionLoader &loader) {
 	// Register function with VARCHAR parameter (single URL)
 	TableFunction sitemap_func("sitemap_urls", {LogicalType::VARCHAR}, SitemapScan, SitemapBind, SitemapInitGlobal);
 	sitemap_func.init_local = SitemapInitLocal;
+	sitemap_func.projection_pushdown = true;
+	sitemap_func.filter_pushdown = true;
 
 	// Named parameters
 	sitemap_func.named_parameters["follow_robots"] = LogicalType::BOOLEAN;
@@ -366,12 +885,16 @@ void RegisterSitemapFunction(ExtensionLoader &loader) {
 	sitemap_func.named_parameters["backoff_ms"] = LogicalType::INTEGER;
 	sitemap_func.named_parameters["max_backoff_ms"] = LogicalType::INTEGER;
 	sitemap_func.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+	sitemap_func.named_parameters["concurrency"] = LogicalType::INTEGER;
+	sitemap_func.named_parameters["modified_since"] = LogicalType::TIMESTAMP;
 
 	loader.RegisterFunction(sitemap_func);
 
 	// Register function with LIST parameter (array of URLs)
 	TableFunction sitemap_func_list("sitemap_urls", {LogicalType::LIST(LogicalType::VARCHAR)}, SitemapScan, SitemapBind, SitemapInitGlobal);
 	sitemap_func_list.init_local = SitemapInitLocal;
+	sitemap_func_list.projection_pushdown = true;
+	sitemap_func_list.filter_pushdown = true;
 
 	// Named parameters
 	sitemap_func_list.named_parameters["follow_robots"] = LogicalType::BOOLEAN;
@@ -380,6 +903,8 @@ void RegisterSitemapFunction(ExtensionLoader &loader) {
 	sitemap_func_list.named_parameters["backoff_ms"] = LogicalType::INTEGER;
 	sitemap_func_list.named_parameters["max_backoff_ms"] = LogicalType::INTEGER;
 	sitemap_func_list.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+	sitemap_func_list.named_parameters["concurrency"] = LogicalType::INTEGER;
+	sitemap_func_list.named_parameters["modified_since"] = LogicalType::TIMESTAMP;
 
 	loader.RegisterFunction(sitemap_func_list);
 }
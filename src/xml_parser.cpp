@@ -1,5 +1,6 @@
 #include "xml_parser.hpp"
 #include <libxml/HTMLparser.h>
+#include <libxml/xpath.h>
 #include <zlib.h>
 #include <cstring>
 #include <algorithm>
@@ -29,86 +30,96 @@ XMLDocRAII::XMLDocRAII(const std::string &content) {
 	doc = xmlReadMemory(content.c_str(), static_cast<int>(content.size()), nullptr, nullptr,
 	                    XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
 
-	if (doc) {
-		xpath_ctx = xmlXPathNewContext(doc);
-		if (xpath_ctx) {
-			// Register both sitemap namespace variants
-			xmlXPathRegisterNs(xpath_ctx, BAD_CAST "sm",
-			                   BAD_CAST "http://www.sitemaps.org/schemas/sitemap/0.9");
-			xmlXPathRegisterNs(xpath_ctx, BAD_CAST "sm2",
-			                   BAD_CAST "http://www.google.com/schemas/sitemap/0.84");
-		}
+}
+
+XMLDocRAII::XMLDocRAII(GzipStreamReader &reader) {
+	// Suppress error output
+	xmlSetGenericErrorFunc(nullptr, SilentErrorHandler);
+
+	auto ctxt = xmlCreatePushParserCtxt(nullptr, nullptr, nullptr, 0, nullptr);
+	if (!ctxt) {
+		return;
+	}
+	xmlCtxtUseOptions(ctxt, XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
+
+	const char *data;
+	size_t size;
+	bool ok = true;
+	while (ok && reader.Read(data, size)) {
+		ok = xmlParseChunk(ctxt, data, static_cast<int>(size), 0) == 0;
 	}
+	if (ok && reader.Error().empty()) {
+		ok = xmlParseChunk(ctxt, nullptr, 0, 1) == 0;
+	}
+
+	// Like xmlReadMemory, only a well-formed document is kept
+	if (ok && reader.Error().empty() && ctxt->wellFormed) {
+		doc = ctxt->myDoc;
+	} else if (ctxt->myDoc) {
+		xmlFreeDoc(ctxt->myDoc);
+	}
+	ctxt->myDoc = nullptr;
+	xmlFreeParserCtxt(ctxt);
 }
 
 XMLDocRAII::~XMLDocRAII() {
-	if (xpath_ctx) {
-		xmlXPathFreeContext(xpath_ctx);
-	}
 	if (doc) {
 		xmlFreeDoc(doc);
 	}
 }
 
-XMLDocRAII::XMLDocRAII(XMLDocRAII &&other) noexcept : doc(other.doc), xpath_ctx(other.xpath_ctx) {
+XMLDocRAII::XMLDocRAII(XMLDocRAII &&other) noexcept : doc(other.doc) {
 	other.doc = nullptr;
-	other.xpath_ctx = nullptr;
 }
 
 XMLDocRAII &XMLDocRAII::operator=(XMLDocRAII &&other) noexcept {
 	if (this != &other) {
-		if (xpath_ctx) {
-			xmlXPathFreeContext(xpath_ctx);
-		}
 		if (doc) {
 			xmlFreeDoc(doc);
 		}
 		doc = other.doc;
-		xpath_ctx = other.xpath_ctx;
 		other.doc = nullptr;
-		other.xpath_ctx = nullptr;
 	}
 	return *this;
 }
 
-// Get text content of first matching XPath node
-static std::string GetXPathText(xmlXPathContextPtr ctx, xmlNodePtr node, const char *xpath) {
-	// Set context node
-	xmlXPathContextPtr local_ctx = xmlXPathNewContext(ctx->doc);
-	if (!local_ctx) {
-		return "";
+// Sitemap namespaces; elements from other namespaces (image:loc, xhtml:link, ...) are ignored
+static bool IsSitemapNamespace(const xmlChar *uri) {
+	if (!uri) {
+		return true;
 	}
+	return xmlStrEqual(uri, BAD_CAST "http://www.sitemaps.org/schemas/sitemap/0.9") ||
+	       xmlStrEqual(uri, BAD_CAST "http://www.google.com/schemas/sitemap/0.84");
+}
 
-	// Register both namespace variants
-	xmlXPathRegisterNs(local_ctx, BAD_CAST "sm", BAD_CAST "http://www.sitemaps.org/schemas/sitemap/0.9");
-	xmlXPathRegisterNs(local_ctx, BAD_CAST "sm2", BAD_CAST "http://www.google.com/schemas/sitemap/0.84");
-
-	local_ctx->node = node;
-
-	xmlXPathObjectPtr result = xmlXPathEvalExpression(BAD_CAST xpath, local_ctx);
-	std::string text;
-
-	if (result && result->nodesetval && result->nodesetval->nodeNr > 0) {
-		xmlNodePtr text_node = result->nodesetval->nodeTab[0];
-		xmlChar *content = xmlNodeGetContent(text_node);
-		if (content) {
-			text = reinterpret_cast<const char *>(content);
-			xmlFree(content);
-		}
+static void TrimInPlace(std::string &str) {
+	size_t start = str.find_first_not_of(" \t\n\r");
+	if (start == std::string::npos) {
+		str.clear();
+		return;
 	}
+	size_t end = str.find_last_not_of(" \t\n\r");
+	str = str.substr(start, end - start + 1);
+}
 
-	if (result) {
-		xmlXPathFreeObject(result);
-	}
-	xmlXPathFreeContext(local_ctx);
+// Element in one of the sitemap namespaces with the given local name
+static bool IsSitemapElement(xmlNodePtr node, const char *name) {
+	return node->type == XML_ELEMENT_NODE && xmlStrEqual(node->name, BAD_CAST name) &&
+	       IsSitemapNamespace(node->ns ? node->ns->href : nullptr);
+}
 
-	return text;
+static void GetNodeText(xmlNodePtr node, std::string &out) {
+	xmlChar *content = xmlNodeGetContent(node);
+	if (content) {
+		out = reinterpret_cast<const char *>(content);
+		xmlFree(content);
+		TrimInPlace(out);
+	}
 }
 
-SitemapParseResult XmlParser::ParseSitemap(const std::string &xml_content) {
+static SitemapParseResult ParseSitemapDocument(XMLDocRAII &doc, const SitemapFields &fields) {
 	SitemapParseResult result;
 
-	XMLDocRAII doc(xml_content);
 	if (!doc.IsValid()) {
 		result.error = "Failed to parse XML";
 		return result;
@@ -127,35 +138,20 @@ SitemapParseResult XmlParser::ParseSitemap(const std::string &xml_content) {
 		// This is a sitemap index
 		result.type = SitemapType::SITEMAPINDEX;
 
-		// Try both namespace variants
-		const char *xpath_variants[] = {"//sm:sitemap/sm:loc", "//sm2:sitemap/sm2:loc"};
-		for (const char *xpath : xpath_variants) {
-			xmlXPathObjectPtr sitemap_nodes = xmlXPathEvalExpression(BAD_CAST xpath, doc.xpath_ctx);
-
-			if (sitemap_nodes && sitemap_nodes->nodesetval && sitemap_nodes->nodesetval->nodeNr > 0) {
-				for (int i = 0; i < sitemap_nodes->nodesetval->nodeNr; i++) {
-					xmlNodePtr node = sitemap_nodes->nodesetval->nodeTab[i];
-					xmlChar *content = xmlNodeGetContent(node);
-					if (content) {
-						std::string loc = reinterpret_cast<const char *>(content);
-						// Trim whitespace
-						size_t start = loc.find_first_not_of(" \t\n\r");
-						size_t end = loc.find_last_not_of(" \t\n\r");
-						if (start != std::string::npos && end != std::string::npos) {
-							result.sitemaps.push_back(loc.substr(start, end - start + 1));
-						}
-						xmlFree(content);
-					}
-				}
+		for (xmlNodePtr sitemap = root->children; sitemap; sitemap = sitemap->next) {
+			if (!IsSitemapElement(sitemap, "sitemap")) {
+				continue;
 			}
-
-			if (sitemap_nodes) {
-				xmlXPathFreeObject(sitemap_nodes);
+			SitemapIndexEntry entry;
+			for (xmlNodePtr child = sitemap->children; child; child = child->next) {
+				if (IsSitemapElement(child, "loc")) {
+					GetNodeText(child, entry.loc);
+				} else if (IsSitemapElement(child, "lastmod")) {
+					GetNodeText(child, entry.lastmod);
+				}
 			}
-
-			// If we found results, stop trying other namespaces
-			if (!result.sitemaps.empty()) {
-				break;
+			if (!entry.loc.empty()) {
+				result.sitemaps.push_back(std::move(entry));
 			}
 		}
 
@@ -165,46 +161,27 @@ SitemapParseResult XmlParser::ParseSitemap(const std::string &xml_content) {
 		// This is a regular sitemap
 		result.type = SitemapType::URLSET;
 
-		// Try both namespace variants
-		const char *xpath_variants[] = {"//sm:url", "//sm2:url"};
-		const char *loc_variants[] = {"sm:loc", "sm2:loc"};
-		const char *lastmod_variants[] = {"sm:lastmod", "sm2:lastmod"};
-		const char *changefreq_variants[] = {"sm:changefreq", "sm2:changefreq"};
-		const char *priority_variants[] = {"sm:priority", "sm2:priority"};
-
-		for (int ns_idx = 0; ns_idx < 2; ns_idx++) {
-			xmlXPathObjectPtr url_nodes = xmlXPathEvalExpression(BAD_CAST xpath_variants[ns_idx], doc.xpath_ctx);
-
-			if (url_nodes && url_nodes->nodesetval && url_nodes->nodesetval->nodeNr > 0) {
-				for (int i = 0; i < url_nodes->nodesetval->nodeNr; i++) {
-					xmlNodePtr url_node = url_nodes->nodesetval->nodeTab[i];
-
-					SitemapEntry entry;
-					entry.url = GetXPathText(doc.xpath_ctx, url_node, loc_variants[ns_idx]);
-					entry.lastmod = GetXPathText(doc.xpath_ctx, url_node, lastmod_variants[ns_idx]);
-					entry.changefreq = GetXPathText(doc.xpath_ctx, url_node, changefreq_variants[ns_idx]);
-					entry.priority = GetXPathText(doc.xpath_ctx, url_node, priority_variants[ns_idx]);
-
-					// Trim URL whitespace
-					size_t start = entry.url.find_first_not_of(" \t\n\r");
-					size_t end = entry.url.find_last_not_of(" \t\n\r");
-					if (start != std::string::npos && end != std::string::npos) {
-						entry.url = entry.url.substr(start, end - start + 1);
-					}
-
-					if (!entry.url.empty()) {
-						result.urls.push_back(std::move(entry));
-					}
-				}
+		// One pass over each <url>'s children fills every selected field
+		for (xmlNodePtr url = root->children; url; url = url->next) {
+			if (!IsSitemapElement(url, "url")) {
+				continue;
 			}
 
-			if (url_nodes) {
-				xmlXPathFreeObject(url_nodes);
+			SitemapEntry entry;
+			for (xmlNodePtr child = url->children; child; child = child->next) {
+				if (IsSitemapElement(child, "loc")) {
+					GetNodeText(child, entry.url);
+				} else if (fields.lastmod && IsSitemapElement(child, "lastmod")) {
+					GetNodeText(child, entry.lastmod);
+				} else if (fields.changefreq && IsSitemapElement(child, "changefreq")) {
+					GetNodeText(child, entry.changefreq);
+				} else if (fields.priority && IsSitemapElement(child, "priority")) {
+					GetNodeText(child, entry.priority);
+				}
 			}
 
-			// If we found results, stop trying other namespaces
-			if (!result.urls.empty()) {
-				break;
+			if (!entry.url.empty()) {
+				result.urls.push_back(std::move(entry));
 			}
 		}
 
@@ -217,73 +194,321 @@ SitemapParseResult XmlParser::ParseSitemap(const std::string &xml_content) {
 	return result;
 }
 
-bool XmlParser::IsGzipped(const std::string &url, const std::string &content_type) {
-	// Check URL extension
-	if (url.length() >= 3) {
-		std::string lower_url = url;
-		std::transform(lower_url.begin(), lower_url.end(), lower_url.begin(),
-		               [](unsigned char c) { return std::tolower(c); });
-		if (lower_url.substr(lower_url.length() - 3) == ".gz") {
-			return true;
+SitemapParseResult XmlParser::ParseSitemap(const std::string &xml_content, SitemapFields fields) {
+	XMLDocRAII doc(xml_content);
+	return ParseSitemapDocument(doc, fields);
+}
+
+SitemapParseResult XmlParser::ParseSitemap(GzipStreamReader &reader, SitemapFields fields) {
+	XMLDocRAII doc(reader);
+	if (!reader.Error().empty()) {
+		SitemapParseResult result;
+		result.error = reader.Error();
+		return result;
+	}
+	return ParseSitemapDocument(doc, fields);
+}
+
+SitemapStreamParser::SitemapStreamParser(EntryCallback on_entry_p, SitemapCallback on_sitemap_p,
+                                         SitemapFields fields_p)
+    : on_entry(std::move(on_entry_p)), on_sitemap(std::move(on_sitemap_p)), fields(fields_p) {
+	xmlSAXHandler handler;
+	memset(&handler, 0, sizeof(handler));
+	handler.initialized = XML_SAX2_MAGIC;
+	handler.startElementNs = OnStartElement;
+	handler.endElementNs = OnEndElement;
+	handler.characters = OnCharacters;
+	handler.cdataBlock = OnCharacters;
+	handler.error = SilentErrorHandler;
+	handler.warning = SilentErrorHandler;
+
+	ctxt = xmlCreatePushParserCtxt(&handler, this, nullptr, 0, nullptr);
+	if (ctxt) {
+		xmlCtxtUseOptions(ctxt, XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
+	} else {
+		error = "Failed to create XML parser";
+	}
+}
+
+SitemapStreamParser::~SitemapStreamParser() {
+	if (ctxt) {
+		if (ctxt->myDoc) {
+			xmlFreeDoc(ctxt->myDoc);
 		}
+		xmlFreeParserCtxt(ctxt);
 	}
+}
 
-	// Check content-type
-	if (content_type.find("gzip") != std::string::npos) {
-		return true;
+bool SitemapStreamParser::CheckParseResult(int ret) {
+	if (!error.empty()) {
+		return false;
+	}
+	if (ret != 0) {
+		error = "Failed to parse XML";
+		return false;
+	}
+	return true;
+}
+
+bool SitemapStreamParser::Feed(const char *data, size_t size) {
+	if (!ctxt || !error.empty()) {
+		return false;
 	}
+	return CheckParseResult(xmlParseChunk(ctxt, data, static_cast<int>(size), 0));
+}
 
-	// Check for gzip magic bytes
-	// gzip files start with 0x1f 0x8b
-	// (We'd need to check the actual content for this, but we don't have it here)
+bool SitemapStreamParser::Finish() {
+	if (!ctxt || !error.empty()) {
+		return false;
+	}
+	if (!CheckParseResult(xmlParseChunk(ctxt, nullptr, 0, 1))) {
+		return false;
+	}
+	if (!has_root) {
+		error = "No root element found";
+		return false;
+	}
+	return true;
+}
 
-	return false;
+std::string *SitemapStreamParser::CurrentText() {
+	switch (field) {
+	case Field::LOC:
+		return &current.url;
+	case Field::LASTMOD:
+		return &current.lastmod;
+	case Field::CHANGEFREQ:
+		return &current.changefreq;
+	case Field::PRIORITY:
+		return &current.priority;
+	default:
+		return nullptr;
+	}
 }
 
-std::string XmlParser::DecompressGzip(const std::string &compressed) {
-	// Check for gzip magic bytes
-	if (compressed.size() < 2 ||
-	    static_cast<unsigned char>(compressed[0]) != 0x1f ||
-	    static_cast<unsigned char>(compressed[1]) != 0x8b) {
-		// Not gzipped, return as-is
-		return compressed;
+void SitemapStreamParser::OnStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix,
+                                         const xmlChar *uri, int nb_namespaces, const xmlChar **namespaces,
+                                         int nb_attributes, int nb_defaulted, const xmlChar **attributes) {
+	auto &parser = *static_cast<SitemapStreamParser *>(ctx);
+	parser.depth++;
+
+	if (!parser.has_root) {
+		parser.has_root = true;
+		if (xmlStrEqual(localname, BAD_CAST "urlset")) {
+			parser.type = SitemapType::URLSET;
+		} else if (xmlStrEqual(localname, BAD_CAST "sitemapindex")) {
+			parser.type = SitemapType::SITEMAPINDEX;
+		} else {
+			parser.error = "Unknown root element: " + std::string(reinterpret_cast<const char *>(localname));
+			xmlStopParser(parser.ctxt);
+		}
+		return;
+	}
+	if (!IsSitemapNamespace(uri)) {
+		return;
 	}
 
-	z_stream zs;
+	if (parser.depth == 2) {
+		const char *item = parser.type == SitemapType::URLSET ? "url" : "sitemap";
+		parser.in_item = xmlStrEqual(localname, BAD_CAST item);
+	} else if (parser.depth == 3 && parser.in_item) {
+		if (xmlStrEqual(localname, BAD_CAST "loc")) {
+			parser.field = Field::LOC;
+		} else if ((parser.type == SitemapType::SITEMAPINDEX || parser.fields.lastmod) &&
+		           xmlStrEqual(localname, BAD_CAST "lastmod")) {
+			parser.field = Field::LASTMOD;
+		} else if (parser.type == SitemapType::URLSET && parser.fields.changefreq &&
+		           xmlStrEqual(localname, BAD_CAST "changefreq")) {
+			parser.field = Field::CHANGEFREQ;
+		} else if (parser.type == SitemapType::URLSET && parser.fields.priority &&
+		           xmlStrEqual(localname, BAD_CAST "priority")) {
+			parser.field = Field::PRIORITY;
+		}
+	}
+}
+
+void SitemapStreamParser::OnEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix,
+                                       const xmlChar *uri) {
+	auto &parser = *static_cast<SitemapStreamParser *>(ctx);
+
+	if (parser.depth == 3) {
+		parser.field = Field::NONE;
+	} else if (parser.depth == 2 && parser.in_item) {
+		parser.in_item = false;
+		auto &entry = parser.current;
+		TrimInPlace(entry.url);
+		if (!entry.url.empty()) {
+			TrimInPlace(entry.lastmod);
+			TrimInPlace(entry.changefreq);
+			TrimInPlace(entry.priority);
+			if (parser.type == SitemapType::URLSET) {
+				parser.on_entry(entry);
+			} else {
+				SitemapIndexEntry sitemap;
+				sitemap.loc = std::move(entry.url);
+				sitemap.lastmod = std::move(entry.lastmod);
+				parser.on_sitemap(sitemap);
+			}
+		}
+		// Reuse the string buffers for the next entry
+		entry.url.clear();
+		entry.lastmod.clear();
+		entry.changefreq.clear();
+		entry.priority.clear();
+	}
+	parser.depth--;
+}
+
+void SitemapStreamParser::OnCharacters(void *ctx, const xmlChar *ch, int len) {
+	auto &parser = *static_cast<SitemapStreamParser *>(ctx);
+	auto text = parser.CurrentText();
+	if (text) {
+		text->append(reinterpret_cast<const char *>(ch), static_cast<size_t>(len));
+	}
+}
+
+SitemapParseResult XmlParser::ParseSitemapStreaming(const std::string &xml_content) {
+	SitemapParseResult result;
+
+	SitemapStreamParser parser([&](SitemapEntry &entry) { result.urls.push_back(std::move(entry)); },
+	                           [&](SitemapIndexEntry &sitemap) { result.sitemaps.push_back(std::move(sitemap)); });
+	if (!parser.Feed(xml_content.data(), xml_content.size()) || !parser.Finish()) {
+		result.error = parser.Error();
+		result.urls.clear();
+		result.sitemaps.clear();
+		return result;
+	}
+
+	result.type = parser.Type();
+	result.success = true;
+	return result;
+}
+
+static bool HasGzipMagic(const Bytef *data, size_t size) {
+	return size >= 2 && data[0] == 0x1f && data[1] == 0x8b;
+}
+
+constexpr size_t GzipStreamReader::BUFFER_SIZE;
+
+GzipStreamReader::GzipStreamReader(const std::string &input_p) : input(input_p) {
 	memset(&zs, 0, sizeof(zs));
+	zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+	zs.avail_in = static_cast<uInt>(input.size());
+
+	gzipped = HasGzipMagic(zs.next_in, zs.avail_in);
+	if (!gzipped) {
+		return;
+	}
 
 	// 16 + MAX_WBITS for gzip format
 	if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
-		return ""; // Decompression init failed
+		error = "Failed to initialize gzip decompression";
+		finished = true;
+		return;
+	}
+	stream_initialized = true;
+}
+
+GzipStreamReader::~GzipStreamReader() {
+	if (stream_initialized) {
+		inflateEnd(&zs);
 	}
+}
 
-	zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
-	zs.avail_in = static_cast<uInt>(compressed.size());
+bool GzipStreamReader::Read(const char *&data, size_t &size) {
+	if (finished) {
+		return false;
+	}
 
-	std::string decompressed;
-	char buffer[32768];
+	if (!gzipped) {
+		if (input_offset >= input.size()) {
+			finished = true;
+			return false;
+		}
+		data = input.data() + input_offset;
+		size = std::min(BUFFER_SIZE, input.size() - input_offset);
+		input_offset += size;
+		return true;
+	}
 
-	int ret;
-	do {
+	while (true) {
 		zs.next_out = reinterpret_cast<Bytef *>(buffer);
-		zs.avail_out = sizeof(buffer);
+		zs.avail_out = BUFFER_SIZE;
 
-		ret = inflate(&zs, Z_NO_FLUSH);
+		int ret = inflate(&zs, Z_NO_FLUSH);
+		size = BUFFER_SIZE - zs.avail_out;
 
-		if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
-			inflateEnd(&zs);
-			return ""; // Decompression failed
+		if (ret == Z_STREAM_END) {
+			// Concatenated gzip members decompress to one document
+			if (HasGzipMagic(zs.next_in, zs.avail_in)) {
+				inflateReset(&zs);
+			} else {
+				finished = true;
+			}
+		} else if (ret == Z_BUF_ERROR) {
+			// No progress possible: the input ended before the gzip trailer
+			error = "Truncated gzip data";
+			finished = true;
+			return false;
+		} else if (ret != Z_OK) {
+			error = "Failed to decompress gzip data";
+			finished = true;
+			return false;
 		}
 
-		size_t have = sizeof(buffer) - zs.avail_out;
-		decompressed.append(buffer, have);
+		if (size > 0) {
+			data = buffer;
+			return true;
+		}
+		if (finished) {
+			return false;
+		}
+	}
+}
 
-	} while (ret != Z_STREAM_END);
+std::string XmlParser::DecompressGzip(const std::string &compressed) {
+	GzipStreamReader reader(compressed);
+	if (!reader.IsGzipped()) {
+		// Not gzipped, return as-is
+		return compressed;
+	}
 
-	inflateEnd(&zs);
+	std::string decompressed;
+	const char *data;
+	size_t size;
+	while (reader.Read(data, size)) {
+		decompressed.append(data, size);
+	}
+	if (!reader.Error().empty()) {
+		return ""; // Decompression failed
+	}
 	return decompressed;
 }
 
+std::string XmlParser::CompressGzip(const std::string &data) {
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+
+	// 16 + MAX_WBITS for gzip format
+	if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return ""; // Compression init failed
+	}
+
+	std::string compressed(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+	zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+	zs.avail_in = static_cast<uInt>(data.size());
+	zs.next_out = reinterpret_cast<Bytef *>(&compressed[0]);
+	zs.avail_out = static_cast<uInt>(compressed.size());
+
+	int ret = deflate(&zs, Z_FINISH);
+	compressed.resize(zs.total_out);
+	deflateEnd(&zs);
+	if (ret != Z_STREAM_END) {
+		return ""; // Compression failed
+	}
+	return compressed;
+}
+
 std::vector<std::string> XmlParser::FindSitemapInHtml(const std::string &html_content) {
 	std::vector<std::string> sitemaps;
 
@@ -326,4 +551,46 @@ std::vector<std::string> XmlParser::FindSitemapInHtml(const std::string &html_co
 	return sitemaps;
 }
 
+SitemapSniff XmlParser::SniffSitemap(const std::string &prefix) {
+	// The first inflated block is all that is needed; a truncated gzip stream only fails later
+	std::string head;
+	GzipStreamReader reader(prefix);
+	const char *data;
+	size_t size;
+	if (reader.Read(data, size)) {
+		head.assign(data, size);
+	}
+
+	// Skip a byte order mark and leading whitespace
+	size_t pos = 0;
+	if (head.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+		pos = 3;
+	}
+	while (pos < head.size() && std::isspace(static_cast<unsigned char>(head[pos]))) {
+		pos++;
+	}
+	if (pos >= head.size()) {
+		return SitemapSniff::NONE;
+	}
+
+	if (head[pos] == '<') {
+		// Root element after the XML declaration, comments and stylesheet instructions
+		auto urlset = head.find("<urlset", pos);
+		auto index = head.find("<sitemapindex", pos);
+		if (urlset == std::string::npos && index == std::string::npos) {
+			return SitemapSniff::NONE;
+		}
+		return urlset < index ? SitemapSniff::URLSET : SitemapSniff::SITEMAPINDEX;
+	}
+
+	// Text sitemap: the first line is an absolute URL
+	auto line_end = head.find_first_of("\r\n", pos);
+	auto line = head.substr(pos, line_end == std::string::npos ? std::string::npos : line_end - pos);
+	if ((line.compare(0, 7, "http://") == 0 || line.compare(0, 8, "https://") == 0) &&
+	    line.find_first_of(" \t<>\"") == std::string::npos) {
+		return SitemapSniff::URL_LIST;
+	}
+	return SitemapSniff::NONE;
+}
+
 } // namespace duckdb
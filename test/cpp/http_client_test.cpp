@@ -0,0 +1,405 @@
+// HttpClient, ResponseCache and the bruteforce functions against a server on 127.0.0.1, for behavior the
+// sqllogictests cannot reach offline.
+//
+// Usage: sitemap_http_client_test (exits non-zero if a check fails)
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "bruteforce_finder.hpp"
+#include "http_client.hpp"
+#include "response_cache.hpp"
+#include "xml_parser.hpp"
+#include "sitemap_extension.hpp"
+#include "local_http_server.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace duckdb;
+using sitemap_benchmark::LocalHttpServer;
+using sitemap_benchmark::LocalResponse;
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                                               \
+	do {                                                                                                               \
+		if (!(condition)) {                                                                                            \
+			fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition);                              \
+			failures++;                                                                                                \
+		}                                                                                                              \
+	} while (0)
+
+static const char *SMALL_BODY = "<?xml version=\"1.0\"?><urlset/>";
+
+// A capped GET of a larger body returns its prefix and headers instead of the abort error
+static void TestCappedGet(Connection &con, const std::string &base_url) {
+	HttpSession session(*con.context, "DuckDB-Sitemap-Test/1.0");
+	RetryConfig config;
+	config.max_retries = 0;
+	HttpRequestOptions options;
+	options.max_body_bytes = 4096;
+
+	auto response = HttpClient::Fetch(session, base_url + "/large.xml", config, options);
+	CHECK(response.success);
+	CHECK(response.truncated);
+	CHECK(response.status_code == 200);
+	CHECK(response.content_type == "application/xml");
+	CHECK(response.content_length == 1024 * 1024);
+	CHECK(response.body.size() == 4096);
+	CHECK(response.body.compare(0, 5, "<?xml") == 0);
+
+	// A body below the cap is returned whole
+	response = HttpClient::Fetch(session, base_url + "/small.xml", config, options);
+	CHECK(response.success);
+	CHECK(!response.truncated);
+	CHECK(response.body == SMALL_BODY);
+}
+
+// Concurrent fetches of the same URL share one request
+static void TestCoalescing(Connection &con, const LocalHttpServer &server) {
+	HttpSession session(*con.context, "DuckDB-Sitemap-Test/1.0");
+	RetryConfig config;
+	config.max_retries = 0;
+	auto requests_before = server.RequestCount();
+
+	static constexpr size_t THREAD_COUNT = 8;
+	std::vector<HttpResponse> responses(THREAD_COUNT);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < THREAD_COUNT; i++) {
+		threads.emplace_back(
+		    [&, i]() { responses[i] = HttpClient::Fetch(session, server.BaseUrl() + "/slow.xml", config); });
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	CHECK(server.RequestCount() - requests_before == 1);
+	for (auto &response : responses) {
+		CHECK(response.success);
+		CHECK(response.body == SMALL_BODY);
+	}
+}
+
+// A cached response is revalidated with If-None-Match and served from the cache on 304. Sessions with
+// another user agent keep their own copy.
+static void TestRevalidation(Connection &con) {
+	std::atomic<size_t> not_modified {0};
+	LocalHttpServer server([&](const std::string &, const std::string &path,
+	                           const std::map<std::string, std::string> &headers) {
+		LocalResponse response;
+		if (path != "/cached.xml") {
+			response.status = 404;
+			response.content_type = "text/html";
+			return response;
+		}
+		response.headers.emplace_back("ETag", "\"v1\"");
+		auto it = headers.find("if-none-match");
+		if (it != headers.end() && it->second == "\"v1\"") {
+			not_modified++;
+			response.status = 304;
+		} else {
+			response.body = SMALL_BODY;
+		}
+		return response;
+	});
+	auto url = server.BaseUrl() + "/cached.xml";
+
+	auto &fs = FileSystem::GetFileSystem(*con.context);
+	auto directory = fs.JoinPath(fs.GetWorkingDirectory(), "sitemap_http_client_test_cache");
+	ResponseCache cache(fs, directory);
+	HttpSession session(*con.context, "DuckDB-Sitemap-Test/1.0");
+	RetryConfig config;
+	config.max_retries = 0;
+
+	auto response = cache.Fetch(session, url, config);
+	CHECK(response.success);
+	CHECK(response.status_code == 200);
+	CHECK(response.etag == "\"v1\"");
+	CHECK(response.body == SMALL_BODY);
+	CHECK(not_modified.load() == 0);
+
+	response = cache.Fetch(session, url, config);
+	CHECK(response.success);
+	CHECK(response.status_code == 304);
+	CHECK(response.etag == "\"v1\"");
+	CHECK(not_modified.load() == 1);
+
+	// The stored copy is gzip-compressed
+	GzipStreamReader reader(response.body);
+	std::string body;
+	const char *data;
+	size_t size;
+	while (reader.Read(data, size)) {
+		body.append(data, size);
+	}
+	CHECK(reader.IsGzipped());
+	CHECK(reader.Error().empty());
+	CHECK(body == SMALL_BODY);
+
+	HttpSession other_session(*con.context, "DuckDB-Sitemap-Test/2.0");
+	response = cache.Fetch(other_session, url, config);
+	CHECK(response.status_code == 200);
+	CHECK(response.body == SMALL_BODY);
+	CHECK(not_modified.load() == 1);
+
+	fs.RemoveDirectory(directory);
+}
+
+// First column of the first row as a string, "NULL" for NULL
+static std::string QueryValue(Connection &con, const std::string &sql) {
+	auto result = con.Query(sql);
+	if (result->HasError()) {
+		fprintf(stderr, "%s: %s\n", sql.c_str(), result->GetError().c_str());
+		failures++;
+		return std::string();
+	}
+	auto value = result->GetValue(0, 0);
+	return value.IsNull() ? "NULL" : value.ToString();
+}
+
+static LocalResponse NotFound() {
+	LocalResponse response;
+	response.status = 404;
+	response.content_type = "text/html";
+	response.body = "<html><body>Not Found</body></html>";
+	return response;
+}
+
+// A directory without an index page answers 404, but its well-known sitemap is still found. A directory
+// whose random file gets the same 404 is pruned; one whose paths are answered differently is not.
+static void TestDirectoryPruning(Connection &con) {
+	LocalHttpServer server([&](const std::string &, const std::string &path) {
+		LocalResponse response;
+		if (path == "/sitemap/sitemap.xml" || path == "/sitemaps/pages.xml") {
+			response.body = SMALL_BODY;
+		} else if (path == "/sitemaps/") {
+			// Directory listing disabled, with its own error page
+			response = NotFound();
+			response.body = "<html><body>Directory listing denied</body></html>";
+		} else {
+			response = NotFound();
+		}
+		return response;
+	});
+	auto base_url = server.BaseUrl();
+
+	CHECK(QueryValue(con, "SELECT bruteforce_find_sitemap('" + base_url + "')") == base_url + "/sitemap/sitemap.xml");
+
+	auto probes = "FROM bruteforce_sitemaps('" + base_url + "')";
+	CHECK(QueryValue(con, "SELECT count(*) " + probes + " WHERE url LIKE '%/map/%'") == "0");
+	CHECK(QueryValue(con, "SELECT count(*) > 1 " + probes + " WHERE url LIKE '%/sitemaps/%'") == "true");
+	CHECK(QueryValue(con, "SELECT string_agg(url, ',' ORDER BY url) " + probes + " WHERE sniff IS NOT NULL") ==
+	      base_url + "/sitemap/sitemap.xml," + base_url + "/sitemaps/pages.xml");
+}
+
+// Later candidates that answer first do not win: the result is the first match in plan order
+static void TestFirstMatch(Connection &con) {
+	LocalHttpServer server([&](const std::string &, const std::string &path) {
+		LocalResponse response;
+		if (path == "/sitemap.xml") {
+			std::this_thread::sleep_for(std::chrono::milliseconds(300));
+			response.body = SMALL_BODY;
+		} else if (path == "/sitemap_index.xml" || path == "/wp-sitemap.xml") {
+			response.body = "<?xml version=\"1.0\"?><sitemapindex/>";
+		} else {
+			response = NotFound();
+		}
+		return response;
+	});
+	auto base_url = server.BaseUrl();
+
+	CHECK(QueryValue(con, "SELECT bruteforce_find_sitemap('" + base_url + "')") == base_url + "/sitemap.xml");
+}
+
+// Every row of a chunk gets its own site's result, probed together on the thread's FetchEngine
+static void TestChunkRows(Connection &con) {
+	LocalHttpServer server([&](const std::string &, const std::string &path) {
+		LocalResponse response;
+		if (path == "/a/sitemap.xml" || path == "/b/sitemap_index.xml") {
+			response.body = SMALL_BODY;
+		} else {
+			response = NotFound();
+		}
+		return response;
+	});
+	auto base_url = server.BaseUrl();
+
+	auto sql = "SELECT string_agg(coalesce(bruteforce_find_sitemap(url), 'NULL'), ',' ORDER BY url) FROM (VALUES ('" +
+	           base_url + "/a'), ('" + base_url + "/b'), ('" + base_url + "/none'), (NULL)) t(url)";
+	CHECK(QueryValue(con, sql) == base_url + "/a/sitemap.xml," + base_url + "/b/sitemap_index.xml,NULL,NULL");
+}
+
+// Candidates are probed with HEAD; only a non-HTML answer, or a server that rejects HEAD, costs a GET,
+// and that GET is capped at the sniffed prefix
+static void TestHeadThenSniff(Connection &con) {
+	std::string large = "<?xml version=\"1.0\"?><urlset>";
+	large.resize(1024 * 1024, ' ');
+	std::atomic<int> html_gets {0};
+	LocalHttpServer server([&](const std::string &method, const std::string &path) {
+		LocalResponse response;
+		if (path == "/sitemap.xml") {
+			if (method == "HEAD") {
+				response.status = 405;
+			}
+			response.body = large;
+		} else if (path == "/sitemap_index.xml") {
+			html_gets += method == "GET";
+			response.content_type = "text/html";
+			response.body = "<html><body>Welcome</body></html>";
+		} else {
+			response = NotFound();
+		}
+		return response;
+	});
+	auto base_url = server.BaseUrl();
+
+	auto probes = "FROM bruteforce_sitemaps('" + base_url + "')";
+	CHECK(QueryValue(con, "SELECT concat_ws(',', status, bytes, sniff) " + probes + " WHERE url = '" + base_url +
+	                          "/sitemap.xml'") == "200,4096,urlset");
+	CHECK(QueryValue(con, "SELECT concat_ws(',', status, bytes, sniff) " + probes + " WHERE url = '" + base_url +
+	                          "/sitemap_index.xml'") == "200,0");
+	CHECK(html_gets == 0);
+}
+
+// A candidate that keeps finding sitemaps moves to the front of the probe order
+static void TestStatsRanking(Connection &con) {
+	std::mutex mutex;
+	std::string first_probe;
+	LocalHttpServer server([&](const std::string &method, const std::string &path) {
+		// Directory probes end in a slash; with one probe in flight the first other HEAD is the top candidate
+		if (method == "HEAD" && path.back() != '/') {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (first_probe.empty()) {
+				first_probe = path;
+			}
+		}
+		LocalResponse response;
+		if (path == "/sitemap-news.xml") {
+			response.body = SMALL_BODY;
+		} else {
+			response = NotFound();
+		}
+		return response;
+	});
+	auto base_url = server.BaseUrl();
+	con.Query("SET sitemap_bruteforce_concurrency = 1");
+
+	idx_t rounds = 0;
+	bool ranked_first = false;
+	while (!ranked_first && rounds < 10) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			first_probe.clear();
+		}
+		CHECK(QueryValue(con, "SELECT bruteforce_find_sitemap('" + base_url + "')") == base_url + "/sitemap-news.xml");
+		std::lock_guard<std::mutex> lock(mutex);
+		ranked_first = first_probe == "/sitemap-news.xml";
+		rounds++;
+	}
+	CHECK(rounds > 1);
+	CHECK(ranked_first);
+	CHECK(QueryValue(con, "SELECT hits FROM sitemap_bruteforce_stats() WHERE candidate = 'sitemap-news.xml'") ==
+	      std::to_string(rounds));
+
+	con.Query("RESET sitemap_bruteforce_concurrency");
+}
+
+// A site that answers every path with the same 200 is a catch-all: only the well-known candidates are probed,
+// and those that get the soft-404 response are rejected
+static void TestSoft404(Connection &con) {
+	LocalHttpServer server([&](const std::string &, const std::string &path) {
+		LocalResponse response;
+		if (path == "/real/sitemap_index.xml") {
+			response.body = "<?xml version=\"1.0\"?><sitemapindex><sitemap><loc>/a.xml</loc></sitemap></sitemapindex>";
+		} else {
+			response.body = SMALL_BODY;
+		}
+		return response;
+	});
+	auto base_url = server.BaseUrl();
+
+	CHECK(QueryValue(con, "SELECT bruteforce_find_sitemap('" + base_url + "/spa')") == "NULL");
+	CHECK(QueryValue(con, "SELECT bruteforce_find_sitemap('" + base_url + "/real')") ==
+	      base_url + "/real/sitemap_index.xml");
+
+	auto probes = "FROM bruteforce_sitemaps('" + base_url + "/spa')";
+	CHECK(QueryValue(con, "SELECT count(*) || ',' || count(sniff) " + probes) ==
+	      std::to_string(BruteforceFinder::GetCommonCandidates().size()) + ",0");
+}
+
+// One row per probe: what the server answered, how much of the body was read and what it looked like
+static void TestProbeColumns(Connection &con) {
+	LocalHttpServer server([&](const std::string &, const std::string &path) {
+		LocalResponse response;
+		if (path == "/sitemap.xml") {
+			response.body = SMALL_BODY;
+		} else {
+			response = NotFound();
+		}
+		return response;
+	});
+	auto base_url = server.BaseUrl();
+	auto probes = "FROM bruteforce_sitemaps('" + base_url + "')";
+
+	CHECK(QueryValue(con, "SELECT string_agg(column_name || ' ' || column_type, ',') FROM (DESCRIBE SELECT * " +
+	                          probes + ")") == "base_url VARCHAR,url VARCHAR,status INTEGER,content_type VARCHAR,"
+	                                           "bytes BIGINT,latency_ms DOUBLE,sniff VARCHAR");
+	auto columns = "SELECT concat_ws(',', base_url, status, content_type, bytes, latency_ms >= 0, sniff) " + probes;
+	CHECK(QueryValue(con, columns + " WHERE url = '" + base_url + "/sitemap.xml'") ==
+	      base_url + ",200,application/xml," + std::to_string(strlen(SMALL_BODY)) + ",true,urlset");
+	CHECK(QueryValue(con, columns + " WHERE url = '" + base_url + "/sitemap_index.xml'") ==
+	      base_url + ",404,text/html,0,true");
+	CHECK(QueryValue(con, "SELECT count(*) FROM bruteforce_sitemaps('" + base_url + "', hits_only := true)") == "1");
+}
+
+int main() {
+	std::string large = "<?xml version=\"1.0\"?>";
+	large.resize(1024 * 1024, ' ');
+	LocalHttpServer server([&](const std::string &, const std::string &path) {
+		LocalResponse response;
+		if (path == "/large.xml") {
+			response.body = large;
+		} else if (path == "/small.xml") {
+			response.body = SMALL_BODY;
+		} else if (path == "/slow.xml") {
+			// Long enough for every concurrent caller to join the in-flight request
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
+			response.body = SMALL_BODY;
+		} else {
+			response.status = 404;
+			response.content_type = "text/html";
+		}
+		return response;
+	});
+
+	DuckDB db(nullptr);
+	db.LoadStaticExtension<SitemapExtension>();
+	Connection con(db);
+	con.Query("SET sitemap_max_host_rps = 0");
+	con.Query("SET sitemap_bruteforce_max_host_rps = 0");
+
+	TestCappedGet(con, server.BaseUrl());
+	TestCoalescing(con, server);
+	TestRevalidation(con);
+	TestDirectoryPruning(con);
+	TestFirstMatch(con);
+	TestChunkRows(con);
+	TestHeadThenSniff(con);
+	TestStatsRanking(con);
+	TestSoft404(con);
+	TestProbeColumns(con);
+
+	if (failures > 0) {
+		fprintf(stderr, "%d check(s) failed\n", failures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}